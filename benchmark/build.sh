@@ -0,0 +1,23 @@
+#!/bin/bash
+
+# exit at first error
+set -e
+
+BMARK_EXE=bmark-queue
+
+rm -f $BMARK_EXE
+rm -rf build/
+
+mkdir build
+cd build
+cmake ../.
+
+echo
+make clean
+make
+
+cd ..
+echo
+echo "++ successfully built:"
+stat --printf="%n - %s bytes\n" $BMARK_EXE
+echo
@@ -0,0 +1,137 @@
+#include <thread>
+#include <vector>
+#include <memory>
+#include <tuple>
+#include <benchmark/benchmark.h>
+
+#include "../../include/concurrent_queue.h"
+#include "../../include/synchronous_queue.h"
+#include "../../include/object_pool.h"
+#include "../../include/ring_buffer.h"
+
+// one round trip: the main thread pings, an echo thread pongs back
+template <class Q>
+void BM_PingPong(benchmark::State& state) {
+    Q ping{};
+    Q pong{};
+
+    std::thread echo_thread{[&ping, &pong]() {
+        int val = 0;
+
+        while (true) {
+            ping.wait_and_pop(val);
+            if (val < 0) {
+                break;
+            }
+            pong.push(val);
+        }
+    }};
+
+    int val = 0;
+    while (state.KeepRunning()) {
+        ping.push(1);
+        pong.wait_and_pop(val);
+    }
+
+    // stop the echo thread
+    ping.push(-1);
+    echo_thread.join();
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_TEMPLATE(BM_PingPong, ConcurrentQueue<int>)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_PingPong, SynchronousQueue<int>)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_PingPong, ConcurrentQueue<int, RingBuffer<int>>)->UseRealTime();
+
+using Tuple = std::tuple<uint32_t, uint32_t, uint32_t>;
+
+// a backlog of small elements drained in batches, as the taxicab consumer sees it
+template <class Q>
+void BM_BulkDrain(benchmark::State& state) {
+    Q queue{};
+    const std::size_t n = state.range(0);
+    std::vector<Tuple> batch{};
+    batch.reserve(256);
+
+    while (state.KeepRunning()) {
+        for (uint32_t i = 0; i < n; ++i) {
+            queue.push(Tuple{i, i, i});
+        }
+
+        std::size_t drained = 0;
+        while (drained < n) {
+            batch.clear();
+            drained += queue.pop_batch(batch, 256, std::chrono::milliseconds{0});
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK_TEMPLATE(BM_BulkDrain, ConcurrentQueue<Tuple>)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_BulkDrain, ConcurrentQueue<Tuple, RingBuffer<Tuple>>)->Arg(1 << 16);
+
+// a batch of 256 integers allocated by the producer and freed by the consumer
+void BM_PayloadHeap(benchmark::State& state) {
+    ConcurrentQueue<std::unique_ptr<std::vector<uint32_t>>> queue{};
+
+    std::thread consumer_thread{[&queue]() {
+        std::unique_ptr<std::vector<uint32_t>> batch{};
+
+        while (true) {
+            queue.wait_and_pop(batch);
+            if (!batch) {
+                break;
+            }
+            batch.reset();
+        }
+    }};
+
+    while (state.KeepRunning()) {
+        std::unique_ptr<std::vector<uint32_t>> batch{new std::vector<uint32_t>(256, 1)};
+        queue.push(std::move(batch));
+    }
+
+    // stop the consumer thread
+    queue.push(std::unique_ptr<std::vector<uint32_t>>{});
+    consumer_thread.join();
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+// the same batch recycled through an ObjectPool
+void BM_PayloadPool(benchmark::State& state) {
+    ObjectPool<std::vector<uint32_t>> pool{};
+    ConcurrentQueue<ObjectPool<std::vector<uint32_t>>::Handle> queue{};
+
+    std::thread consumer_thread{[&queue]() {
+        ObjectPool<std::vector<uint32_t>>::Handle batch{};
+
+        while (true) {
+            queue.wait_and_pop(batch);
+            if (!batch) {
+                break;
+            }
+            batch.reset();
+        }
+    }};
+
+    while (state.KeepRunning()) {
+        auto batch = pool.acquire();
+        batch->assign(256, 1);
+        queue.push(std::move(batch));
+    }
+
+    // stop the consumer thread
+    queue.push(ObjectPool<std::vector<uint32_t>>::Handle{});
+    consumer_thread.join();
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_PayloadHeap)->UseRealTime();
+BENCHMARK(BM_PayloadPool)->UseRealTime();
+
+// run the benchmark
+BENCHMARK_MAIN();
@@ -7,19 +7,21 @@
 
 // passed as defines, for example:
 // -DBMARK_POW_N=5 -DBMARK_POW_R=2 -DBMARK_SIZE_T=1
-const uint32_t bmark_N = std::pow(10, BMARK_POW_N);
+const uint64_t bmark_N = std::pow(10, BMARK_POW_N);
 const uint32_t bmark_R = std::pow(10, BMARK_POW_R);
 const uint32_t bmark_T = BMARK_SIZE_T;
 
 std::chrono::milliseconds timeout{10};
 std::chrono::milliseconds check{1};
 
-template <class T>
+template <class T, Engine E = Engine::brute, uint32_t C = 1>
 class BenchmarkTaxiCab : public ::benchmark::Fixture {
     public:
         void SetUp(const ::benchmark::State& st) {
             taxicab.display_filename(true);
             taxicab.write_json(true);
+            taxicab.search_engine(E);
+            taxicab.consumer_threads(C);
         }
 
         void TearDown(const ::benchmark::State&) {
@@ -47,5 +49,141 @@ BENCHMARK_DEFINE_F(BenchmarkTaxiCabInt, inst)(benchmark::State& state) {
 
 BENCHMARK_REGISTER_F(BenchmarkTaxiCabInt, inst);
 
+using BenchmarkTaxiCabPipe = BenchmarkTaxiCab<TaxiCabNumberPipe>;
+BENCHMARK_DEFINE_F(BenchmarkTaxiCabPipe, inst)(benchmark::State& state) {
+    while (state.KeepRunning()) {
+        taxicab.run();
+    }
+}
+
+BENCHMARK_REGISTER_F(BenchmarkTaxiCabPipe, inst);
+
+using BenchmarkTaxiCabFlat = BenchmarkTaxiCab<TaxiCabNumberFlat>;
+BENCHMARK_DEFINE_F(BenchmarkTaxiCabFlat, inst)(benchmark::State& state) {
+    while (state.KeepRunning()) {
+        taxicab.run();
+    }
+}
+
+BENCHMARK_REGISTER_F(BenchmarkTaxiCabFlat, inst);
+
+using BenchmarkTaxiCabStrPairs = BenchmarkTaxiCab<TaxiCabNumberStr, Engine::pairs>;
+BENCHMARK_DEFINE_F(BenchmarkTaxiCabStrPairs, inst)(benchmark::State& state) {
+    while (state.KeepRunning()) {
+        taxicab.run();
+    }
+}
+
+BENCHMARK_REGISTER_F(BenchmarkTaxiCabStrPairs, inst);
+
+using BenchmarkTaxiCabIntPairs = BenchmarkTaxiCab<TaxiCabNumberInt, Engine::pairs>;
+BENCHMARK_DEFINE_F(BenchmarkTaxiCabIntPairs, inst)(benchmark::State& state) {
+    while (state.KeepRunning()) {
+        taxicab.run();
+    }
+}
+
+BENCHMARK_REGISTER_F(BenchmarkTaxiCabIntPairs, inst);
+
+using BenchmarkTaxiCabFlatPairs = BenchmarkTaxiCab<TaxiCabNumberFlat, Engine::pairs>;
+BENCHMARK_DEFINE_F(BenchmarkTaxiCabFlatPairs, inst)(benchmark::State& state) {
+    while (state.KeepRunning()) {
+        taxicab.run();
+    }
+}
+
+BENCHMARK_REGISTER_F(BenchmarkTaxiCabFlatPairs, inst);
+
+using BenchmarkTaxiCabStrWindow = BenchmarkTaxiCab<TaxiCabNumberStr, Engine::window>;
+BENCHMARK_DEFINE_F(BenchmarkTaxiCabStrWindow, inst)(benchmark::State& state) {
+    while (state.KeepRunning()) {
+        taxicab.run();
+    }
+}
+
+BENCHMARK_REGISTER_F(BenchmarkTaxiCabStrWindow, inst);
+
+using BenchmarkTaxiCabFlatWindow = BenchmarkTaxiCab<TaxiCabNumberFlat, Engine::window>;
+BENCHMARK_DEFINE_F(BenchmarkTaxiCabFlatWindow, inst)(benchmark::State& state) {
+    while (state.KeepRunning()) {
+        taxicab.run();
+    }
+}
+
+BENCHMARK_REGISTER_F(BenchmarkTaxiCabFlatWindow, inst);
+
+// the pairs engine saturates a single consumer first
+using BenchmarkTaxiCabStrPairsShards = BenchmarkTaxiCab<TaxiCabNumberStr, Engine::pairs, 4>;
+BENCHMARK_DEFINE_F(BenchmarkTaxiCabStrPairsShards, inst)(benchmark::State& state) {
+    while (state.KeepRunning()) {
+        taxicab.run();
+    }
+}
+
+BENCHMARK_REGISTER_F(BenchmarkTaxiCabStrPairsShards, inst);
+
+using BenchmarkTaxiCabStrHeap = BenchmarkTaxiCab<TaxiCabNumberStr, Engine::heap>;
+BENCHMARK_DEFINE_F(BenchmarkTaxiCabStrHeap, inst)(benchmark::State& state) {
+    while (state.KeepRunning()) {
+        taxicab.run();
+    }
+}
+
+BENCHMARK_REGISTER_F(BenchmarkTaxiCabStrHeap, inst);
+
+// the first run fills the cache, the others read it
+class BenchmarkTaxiCabFlatCached : public BenchmarkTaxiCab<TaxiCabNumberFlat> {
+    public:
+        void SetUp(const ::benchmark::State& st) {
+            BenchmarkTaxiCab<TaxiCabNumberFlat>::SetUp(st);
+            taxicab.cache_dir("output/cache");
+        }
+};
+
+BENCHMARK_DEFINE_F(BenchmarkTaxiCabFlatCached, inst)(benchmark::State& state) {
+    while (state.KeepRunning()) {
+        taxicab.run();
+    }
+}
+
+BENCHMARK_REGISTER_F(BenchmarkTaxiCabFlatCached, inst);
+
+// the brute engine's kernel at one level, skipped above the CPU's
+template <SimdLevel S>
+class BenchmarkTaxiCabSimd : public BenchmarkTaxiCab<TaxiCabNumberStr> {
+    public:
+        void SetUp(const ::benchmark::State& st) {
+            BenchmarkTaxiCab<TaxiCabNumberStr>::SetUp(st);
+            taxicab.simd_level(S);
+        }
+
+        // the body of every level
+        void run_level(benchmark::State& state) {
+            if (taxicab.simd_level() != S) {
+                state.SkipWithError("not supported by this CPU");
+                return;
+            }
+            while (state.KeepRunning()) {
+                taxicab.run();
+            }
+        }
+};
+
+using BenchmarkTaxiCabSimdScalar = BenchmarkTaxiCabSimd<SimdLevel::scalar>;
+BENCHMARK_DEFINE_F(BenchmarkTaxiCabSimdScalar, inst)(benchmark::State& state) { run_level(state); }
+BENCHMARK_REGISTER_F(BenchmarkTaxiCabSimdScalar, inst);
+
+using BenchmarkTaxiCabSimdSse41 = BenchmarkTaxiCabSimd<SimdLevel::sse41>;
+BENCHMARK_DEFINE_F(BenchmarkTaxiCabSimdSse41, inst)(benchmark::State& state) { run_level(state); }
+BENCHMARK_REGISTER_F(BenchmarkTaxiCabSimdSse41, inst);
+
+using BenchmarkTaxiCabSimdAvx2 = BenchmarkTaxiCabSimd<SimdLevel::avx2>;
+BENCHMARK_DEFINE_F(BenchmarkTaxiCabSimdAvx2, inst)(benchmark::State& state) { run_level(state); }
+BENCHMARK_REGISTER_F(BenchmarkTaxiCabSimdAvx2, inst);
+
+using BenchmarkTaxiCabSimdAvx512 = BenchmarkTaxiCabSimd<SimdLevel::avx512>;
+BENCHMARK_DEFINE_F(BenchmarkTaxiCabSimdAvx512, inst)(benchmark::State& state) { run_level(state); }
+BENCHMARK_REGISTER_F(BenchmarkTaxiCabSimdAvx512, inst);
+
 // run the benchmark
 BENCHMARK_MAIN();
@@ -0,0 +1,89 @@
+#ifndef CUBE_KERNEL_H
+#define CUBE_KERNEL_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/**
+ * SIMD search kernel for the brute engine
+ *
+ * The cubes 1^3 .. (R-1)^3 sit in a 64-byte aligned table, a target sum is
+ * compared with 2 (SSE4.1), 4 (AVX2) or 8 (AVX-512) cubes per instruction and
+ * the lane of a match is taken from the comparison mask.
+ * The instruction set is picked at run time, the kernels are compiled with
+ * target attributes so the binary runs on any x86-64 machine.
+ * see:
+ *      https://gcc.gnu.org/onlinedocs/gcc/x86-Function-Attributes.html
+ *      https://gcc.gnu.org/onlinedocs/gcc/x86-Built-in-Functions.html
+ */
+
+// in increasing order of width, a level implies the ones below it
+enum class SimdLevel {scalar, sse41, avx2, avx512};
+
+// the widest level of this CPU
+SimdLevel simd_detect();
+
+const char* simd_name(const SimdLevel level);
+
+// the index of the first cube equal to target, or n; n is a multiple of 8
+using CubeMatch = std::size_t (*)(const uint64_t* cubes, const std::size_t n, const uint64_t target);
+
+CubeMatch simd_match(const SimdLevel level);
+
+class CubeKernel {
+    public:
+        // lanes of the widest kernel, the table is padded to a multiple of it
+        static const std::size_t PAD = 8;
+
+        CubeKernel() = default;                                         // default constructor
+        CubeKernel(const CubeKernel&) = delete;                         // copy constructor
+        CubeKernel& operator=(const CubeKernel&) = delete;              // copy assignment
+
+        // the cubes of [1, n_range)
+        void reset(const uint32_t n_range, const SimdLevel level) {
+            _size = n_range > 0 ? n_range - 1 : 0;
+            _padded = (_size + PAD - 1) / PAD * PAD;
+            // a cache line of slack for the alignment
+            _storage.assign(_padded + PAD, UINT64_MAX);
+
+            std::size_t offset = (64 - reinterpret_cast<uintptr_t>(_storage.data()) % 64) % 64 / sizeof(uint64_t);
+            _cubes = _storage.data() + offset;
+
+            for (std::size_t k = 0; k < _size; ++k) {
+                uint64_t c = k + 1;
+                _cubes[k] = c * c * c;
+            }
+
+            _match = simd_match(level);
+        }
+
+        // emit(i, j, k) for every i in [n_start, n_end) with i = j^3 + k^3, j and k in increasing order as the scalar loop
+        template<typename Emit>
+        void search(const uint64_t n_start, const uint64_t n_end, Emit emit) const {
+            for (uint64_t i = n_start; i < n_end; ++i) {
+                for (std::size_t j = 0; j < _size; ++j) {
+                    uint64_t j3 = _cubes[j];
+
+                    // the cubes increase, no k^3 >= 1 is left
+                    if (j3 >= i) {
+                        break;
+                    }
+
+                    std::size_t k = _match(_cubes, _padded, i - j3);
+                    if (k < _size) {
+                        emit(i, static_cast<uint32_t>(j + 1), static_cast<uint32_t>(k + 1));
+                    }
+                }
+            }
+        }
+
+    private:
+        std::vector<uint64_t> _storage{};
+        uint64_t* _cubes = nullptr;                     // 64-byte aligned, UINT64_MAX after the last cube
+        std::size_t _size = 0;
+        std::size_t _padded = 0;
+        CubeMatch _match = nullptr;
+};
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef CUBE_MATH_H
+#define CUBE_MATH_H
+
+#include <cstdint>
+#include <cmath>
+
+/**
+ * Cube arithmetic for 64-bit sums of cubes
+ *
+ * Products are formed in 128 bits, a result that does not fit in 64 bits is
+ * reported instead of wrapping around.
+ * see:
+ *      https://gcc.gnu.org/onlinedocs/gcc/_005f_005fint128.html
+ */
+
+__extension__ typedef unsigned __int128 cube_uint128_t;
+
+// a^3, false if it does not fit in 64 bits
+inline bool cube_checked(const uint64_t a, uint64_t& a3) {
+    cube_uint128_t a2 = static_cast<cube_uint128_t>(a) * a;
+
+    if (a2 >> 64 != 0) {
+        return false;
+    }
+
+    cube_uint128_t c = a2 * a;
+
+    if (c >> 64 != 0) {
+        return false;
+    }
+
+    a3 = static_cast<uint64_t>(c);
+    return true;
+}
+
+// x + y, false if it does not fit in 64 bits
+inline bool sum_checked(const uint64_t x, const uint64_t y, uint64_t& s) {
+    cube_uint128_t c = static_cast<cube_uint128_t>(x) + y;
+
+    if (c >> 64 != 0) {
+        return false;
+    }
+
+    s = static_cast<uint64_t>(c);
+    return true;
+}
+
+// 10^p, false if it does not fit in 64 bits
+inline bool pow10_checked(const int p, uint64_t& x) {
+    cube_uint128_t c = 1;
+
+    for (int i = 0; i < p; ++i) {
+        c *= 10;
+
+        if (c >> 64 != 0) {
+            return false;
+        }
+    }
+
+    x = static_cast<uint64_t>(c);
+    return true;
+}
+
+// floor of the cube root, exact over the whole 64-bit range
+inline uint64_t cube_root(const uint64_t x) {
+    uint64_t r = static_cast<uint64_t>(std::cbrt(static_cast<double>(x)));
+    uint64_t c = 0;
+
+    while (r > 0 && (!cube_checked(r, c) || c > x)) {
+        --r;
+    }
+    while (cube_checked(r + 1, c) && c <= x) {
+        ++r;
+    }
+
+    return r;
+}
+
+#endif
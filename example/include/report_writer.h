@@ -0,0 +1,202 @@
+#ifndef REPORT_WRITER_H
+#define REPORT_WRITER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cerrno>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#if __cplusplus >= 201703L  // C++17
+#include <charconv>
+#endif
+
+/**
+ * Report writer
+ *
+ * Text is appended to one reusable buffer, integers are formatted in place
+ * and a full buffer goes to the file descriptor in a single write.
+ * Without a file the buffer grows and str() returns the text, so a single
+ * entry can be formatted on another thread and appended later.
+ * see:
+ *      https://en.cppreference.com/w/cpp/utility/to_chars
+ */
+
+class ReportWriter {
+    public:
+        static const std::size_t BUFFER_SIZE = 1 << 20;
+
+        ReportWriter() = default;                                       // default constructor
+        ReportWriter(const ReportWriter&) = delete;                     // copy constructor
+        ReportWriter& operator=(const ReportWriter&) = delete;          // copy assignment
+
+        ~ReportWriter() {
+            close();
+        }
+
+        bool open(const std::string& file_name) {
+            close();
+
+            _fd = ::open(file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            _good = _fd >= 0;
+            _buffer.resize(BUFFER_SIZE);
+            _used = 0;
+
+            return _good;
+        }
+
+        // flushes, false if any write failed
+        bool close() {
+            if (_fd >= 0) {
+                flush();
+                if (::close(_fd) != 0) {
+                    _good = false;
+                }
+                _fd = -1;
+            }
+
+            return _good;
+        }
+
+        // flushes and waits for the disk, before a rename that must not expose a partial file
+        bool sync() {
+            if (_fd >= 0) {
+                flush();
+                if (::fsync(_fd) != 0) {
+                    _good = false;
+                }
+            }
+
+            return _good;
+        }
+
+        bool good() const {
+            return _good;
+        }
+
+        // the text of a writer without a file
+        std::string str() const {
+            return std::string(_buffer.data(), _used);
+        }
+
+        void clear() {
+            _used = 0;
+        }
+
+        ReportWriter& put(const char c) {
+            reserve(1)[0] = c;
+            _used += 1;
+            return *this;
+        }
+
+        ReportWriter& put(const char* s, const std::size_t n) {
+            // a large block bypasses a file's buffer
+            if (_fd >= 0 && n >= BUFFER_SIZE) {
+                flush();
+                write_all(s, n);
+                return *this;
+            }
+
+            std::memcpy(reserve(n), s, n);
+            _used += n;
+            return *this;
+        }
+
+        ReportWriter& put(const char* s) {
+            return put(s, std::strlen(s));
+        }
+
+        ReportWriter& put(const std::string& s) {
+            return put(s.data(), s.size());
+        }
+
+        // right-aligned in width characters as std::setw
+        ReportWriter& put_right(const std::string& s, const std::size_t width) {
+            pad(s.size(), width);
+            return put(s);
+        }
+
+        ReportWriter& put_uint(const uint64_t value, const std::size_t width=0) {
+            char digits[20];
+            std::size_t n = format_uint(digits, value);
+
+            pad(n, width);
+            return put(digits, n);
+        }
+
+        // decimal digits of value at out, returns their number
+        static std::size_t format_uint(char* out, uint64_t value) {
+#if __cplusplus >= 201703L  // C++17
+            return static_cast<std::size_t>(std::to_chars(out, out + 20, value).ptr - out);
+#else
+            char reversed[20];
+            std::size_t n = 0;
+
+            do {
+                reversed[n++] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            } while (value != 0);
+
+            for (std::size_t i = 0; i < n; ++i) {
+                out[i] = reversed[n - 1 - i];
+            }
+
+            return n;
+#endif
+        }
+
+    private:
+        // room for n more characters
+        char* reserve(const std::size_t n) {
+            if (_used + n > _buffer.size()) {
+                if (_fd >= 0) {
+                    flush();
+                }
+                if (_used + n > _buffer.size()) {
+                    _buffer.resize(std::max(2 * _buffer.size(), _used + n));
+                }
+            }
+
+            return _buffer.data() + _used;
+        }
+
+        void pad(const std::size_t n, const std::size_t width) {
+            if (n < width) {
+                std::memset(reserve(width - n), ' ', width - n);
+                _used += width - n;
+            }
+        }
+
+        void flush() {
+            write_all(_buffer.data(), _used);
+            _used = 0;
+        }
+
+        void write_all(const char* data, std::size_t n) {
+            while (n > 0 && _good) {
+                ssize_t written = ::write(_fd, data, n);
+
+                if (written < 0) {
+                    if (errno != EINTR) {
+                        _good = false;
+                    }
+                    continue;
+                }
+
+                data += written;
+                n -= static_cast<std::size_t>(written);
+            }
+        }
+
+        std::vector<char> _buffer{};
+        std::size_t _used = 0;
+        int _fd = -1;
+        bool _good = true;
+};
+
+#endif
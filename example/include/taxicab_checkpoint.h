@@ -0,0 +1,45 @@
+#ifndef TAXICAB_CHECKPOINT_H
+#define TAXICAB_CHECKPOINT_H
+
+#include <cstdint>
+
+/**
+ * Checkpoint file
+ *
+ * The state of an interrupted run between two segments: the producers' cursor,
+ * below which every chunk is done, and the saved sums of all shards:
+ *
+ *      TaxiCabCheckpointHeader
+ *      TaxiCabCheckpointRecord records[]               in no order
+ *      uint64_t total_records                          a truncated file fails this check
+ *
+ * A checkpoint is written to a temporary file that is renamed over the last one,
+ * so there is always a complete checkpoint or none.
+ * see:
+ *      https://man7.org/linux/man-pages/man2/rename.2.html
+ */
+
+struct TaxiCabCheckpointHeader {
+    char magic[8];                                      // "TAXICKP"
+    uint32_t version;
+    uint32_t engine;                                    // Engine as an integer
+    uint64_t n;
+    uint64_t n_low;                                     // of an extended run, else 0
+    uint64_t r;
+    uint64_t t;
+    uint64_t next;                                      // the cursor of the engine's range
+    uint64_t sum_count;                                 // the heap and window engines' count of sums
+    uint64_t elapsed_ms;                                // of all segments so far
+};
+
+// one saved pair of a sum, i = a^3 + b^3
+struct TaxiCabCheckpointRecord {
+    uint64_t i;
+    uint32_t a;
+    uint32_t b;
+};
+
+static const char TAXICAB_CHECKPOINT_MAGIC[8] = "TAXICKP";
+static const uint32_t TAXICAB_CHECKPOINT_VERSION = 2;
+
+#endif
@@ -2,6 +2,7 @@
 #define TAXICAB_NUMBER_H
 
 #include <cstdint>
+#include <cstdio>
 #include <vector>
 #include <map>
 #include <sstream>
@@ -11,8 +12,22 @@
 #include <chrono>
 #include <ctime>
 #include <utility>
+#include <tuple>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <functional>
+#include <string>
+#include <stdexcept>
 
 #include "../../include/concurrent_queue.h"
+#include "../../include/ring_buffer.h"
+#include "../../include/partitioned_queue.h"
+#include "../../include/pipeline.h"
+#include "cube_math.h"
+#include "cube_kernel.h"
+#include "taxicab_checkpoint.h"
 #include "utility.h"
 
 /**
@@ -26,18 +41,280 @@
  *      https://gcc.gnu.org/onlinedocs/gcc/Other-Builtins.html
  */
 
+// the cubes a <= b of a sum, R is at most 10^6
+using CubePair = std::pair<uint32_t, uint32_t>;
+
 struct TaxiCab {
-    TaxiCab(uint32_t tc) {
+    TaxiCab(uint64_t tc) {
         taxicab_no = tc;
     }
-    uint32_t taxicab_no;
-    std::vector<std::pair<uint16_t, uint16_t>> cube;
+    uint64_t taxicab_no;
+    std::vector<CubePair> cube;
+};
+
+// i = j^3 + k^3 as {i, j, k}, i fits in 64 bits
+using CubeSum = std::tuple<uint64_t, uint32_t, uint32_t>;
+
+// brute: every i of the range tries all (j, k), O(N R^2)
+// pairs: enumerates a <= b with a^3 + b^3 <= N, O(R^2)
+// heap: the sums in increasing order, only those of two or more pairs are pushed, O(R^2 log R) time and O(R) memory
+// window: counts the sums of a cache-sized window of numbers at a time, only those of two or more pairs are pushed
+enum class Engine {brute, pairs, heap, window};
+
+// of the search results in the names of cache files, a change of the results needs a new version
+static const uint32_t TAXICAB_CACHE_VERSION = 1;
+
+// small elements in a contiguous ring instead of std::deque's chunks
+template<typename M>
+using RingQueue = ConcurrentQueue<M, RingBuffer<M>>;
+
+// sums keyed by i, every i goes to one consumer's partition
+using CubeQueue = PartitionedQueue<uint64_t, CubeSum, std::hash<uint64_t>, RingBuffer<CubeSum>>;
+
+// hands out [start, end) chunks of a range to any number of producers,
+// guided: a chunk is a share of what is left, large at first and small at the end
+class ChunkCursor {
+    public:
+        // max_chunk bounds the time between checkpoints
+        void reset(const uint64_t first, const uint64_t last, const uint32_t workers, const uint64_t min_chunk=1, const uint64_t max_chunk=UINT64_MAX) {
+            _next = first;
+            _last = last;
+            _workers = workers > 0 ? workers : 1;
+            _min_chunk = min_chunk > 0 ? min_chunk : 1;
+            _max_chunk = std::max(_min_chunk, max_chunk);
+        }
+
+        // skips the chunks below position, done before a checkpoint was taken
+        void advance(const uint64_t position) {
+            if (position > _next) {
+                _next = position;
+            }
+        }
+
+        // every chunk below it has been handed out
+        uint64_t position() const {
+            return _next.load();
+        }
+
+        bool done() const {
+            return _next.load() >= _last;
+        }
+
+        bool next(uint64_t& start, uint64_t& end) {
+            uint64_t current = _next.load(std::memory_order_relaxed);
+
+            do {
+                if (current >= _last) {
+                    return false;
+                }
+
+                uint64_t chunk = std::min(_max_chunk, std::max(_min_chunk, (_last - current) / (2 * _workers)));
+                end = std::min(_last, current + chunk);
+            } while (!_next.compare_exchange_weak(current, end, std::memory_order_relaxed));
+
+            start = current;
+            return true;
+        }
+
+    private:
+        std::atomic<uint64_t> _next{0};
+        uint64_t _last = 0;
+        uint64_t _workers = 1;
+        uint64_t _min_chunk = 1;
+        uint64_t _max_chunk = UINT64_MAX;
+};
+
+// open addressing with linear probing, the pairs of a number live inline in its slot:
+// an insert is a hash and usually one cache line, no node allocation and no string work
+class CubeTable {
+    public:
+        // a number below 10^18 has at most 6 pairs, a slot fills a 64-byte cache line
+        static const std::size_t MAX_PAIRS = 6;
+        static const std::size_t MIN_CAPACITY = 1024;
+
+        struct Slot {
+            uint64_t key;                               // 0 marks an empty slot, a sum of cubes is at least 2
+            uint32_t count;
+            CubePair pairs[MAX_PAIRS];
+        };
+
+        CubeTable() : _slots(MIN_CAPACITY) {}
+
+        // a pair already in the slot is ignored
+        void insert(const uint64_t key, const uint32_t a, const uint32_t b) {
+            if (2 * (_size + 1) > _slots.size()) {
+                grow();
+            }
+
+            Slot& slot = probe(_slots, key);
+            if (slot.key == 0) { // first time
+                slot.key = key;
+                ++_size;
+            }
+
+            CubePair ab{a, b};
+            for (uint32_t p = 0; p < slot.count; ++p) {
+                if (slot.pairs[p] == ab) {
+                    return;
+                }
+            }
+
+            if (slot.count < MAX_PAIRS) {
+                slot.pairs[slot.count++] = ab;
+            }
+        }
+
+        // the occupied slots in table order
+        template<typename Visit>
+        void for_each(Visit visit) const {
+            for (auto& slot : _slots) {
+                if (slot.key != 0) {
+                    visit(slot);
+                }
+            }
+        }
+
+        std::size_t size() const {
+            return _size;
+        }
+
+        // keeps the table's capacity
+        void clear() {
+            std::fill(_slots.begin(), _slots.end(), Slot{});
+            _size = 0;
+        }
+
+    private:
+        // Fibonacci hashing spreads consecutive sums over the table
+        static Slot& probe(std::vector<Slot>& slots, const uint64_t key) {
+            std::size_t mask = slots.size() - 1;
+            std::size_t s = ((key * UINT64_C(0x9E3779B97F4A7C15)) >> 32) & mask;
+
+            while (slots[s].key != 0 && slots[s].key != key) {
+                s = (s + 1) & mask;
+            }
+
+            return slots[s];
+        }
+
+        void grow() {
+            std::vector<Slot> slots(2 * _slots.size());
+
+            for (auto& slot : _slots) {
+                if (slot.key != 0) {
+                    probe(slots, slot.key) = slot;
+                }
+            }
+
+            _slots.swap(slots);
+        }
+
+        std::vector<Slot> _slots;                       // a power of two, at most half full
+        std::size_t _size = 0;
+};
+
+// the pairs of a number in one uint64_t, with w = bits of R - 1 per cube:
+// a single pair inline as b << w | a, two or more pairs in the arena of the shard,
+// then the top bit is set and the value holds the count and the offset of the block
+class PackedPairs {
+    public:
+        static const uint64_t ARENA = UINT64_C(1) << 63;
+        static const uint32_t COUNT_SHIFT = 40;         // 40 bits of offset, 23 bits of count
+
+        explicit PackedPairs(uint32_t R) {
+            while (_width < 32 && (UINT64_C(1) << _width) < R) {
+                ++_width;
+            }
+            _mask = (UINT64_C(1) << _width) - 1;
+        }
+
+        uint64_t pack(const uint32_t a, const uint32_t b) const {
+            return (uint64_t{b} << _width) | a;
+        }
+
+        CubePair unpack(const uint64_t x) const {
+            return CubePair{static_cast<uint32_t>(x & _mask), static_cast<uint32_t>(x >> _width)};
+        }
+
+        // returns the value with one more pair, a pair already there is ignored
+        uint64_t add(const uint64_t value, const uint32_t a, const uint32_t b) {
+            uint64_t ab = pack(a, b);
+
+            if ((value & ARENA) == 0) {
+                if (value == ab) {
+                    return value;
+                }
+
+                uint64_t offset = _arena.size();
+                _arena.push_back(value);
+                _arena.push_back(ab);
+                return ARENA | (UINT64_C(2) << COUNT_SHIFT) | offset;
+            }
+
+            uint64_t offset = value & OFFSET_MASK;
+            uint64_t count = (value & ~ARENA) >> COUNT_SHIFT;
+
+            for (uint64_t p = offset; p < offset + count; ++p) {
+                if (_arena[p] == ab) {
+                    return value;
+                }
+            }
+
+            // a block grows in place only at the end of the arena, otherwise it moves there
+            if (offset + count != _arena.size()) {
+                uint64_t moved = _arena.size();
+
+                for (uint64_t p = 0; p < count; ++p) {
+                    uint64_t old = _arena[offset + p];
+                    _arena.push_back(old);
+                }
+                offset = moved;
+            }
+
+            _arena.push_back(ab);
+            return ARENA | ((count + 1) << COUNT_SHIFT) | offset;
+        }
+
+        std::size_t count(const uint64_t value) const {
+            return (value & ARENA) == 0 ? 1 : static_cast<std::size_t>((value & ~ARENA) >> COUNT_SHIFT);
+        }
+
+        template<typename Visit>
+        void for_each(const uint64_t value, Visit visit) const {
+            if ((value & ARENA) == 0) {
+                visit(unpack(value));
+                return;
+            }
+
+            uint64_t offset = value & OFFSET_MASK;
+            uint64_t count = (value & ~ARENA) >> COUNT_SHIFT;
+
+            for (uint64_t p = offset; p < offset + count; ++p) {
+                visit(unpack(_arena[p]));
+            }
+        }
+
+        std::size_t arena_size() const {
+            return _arena.size();
+        }
+
+        // keeps the arena's capacity
+        void clear() {
+            _arena.clear();
+        }
+
+    private:
+        static const uint64_t OFFSET_MASK = (UINT64_C(1) << COUNT_SHIFT) - 1;
+
+        uint32_t _width = 1;
+        uint64_t _mask = 1;
+        std::vector<uint64_t> _arena{};                 // packed pairs, moved blocks leave gaps
 };
 
 // the interface
 class Base {
     public:
-        Base(uint32_t N,
+        Base(uint64_t N,
              uint32_t R,
              uint32_t T,
              std::chrono::milliseconds& timeout,
@@ -49,61 +326,163 @@ class Base {
              _timeout{timeout},
              _check{check},
              _prefix{prefix}
-        {}
+        {
+            uint64_t r3 = 0;
+            uint64_t sum = 0;
+
+            // every sum of two cubes below R has to fit in 64 bits
+            if (_R > 0 && !(cube_checked(_R - 1, r3) && sum_checked(r3, r3, sum))) {
+                throw std::invalid_argument("integer cube range is too big for 64-bit sums: " + std::to_string(_R));
+            }
+        }
 
         virtual ~Base() {}
 
-        virtual void find_taxicab_number(const uint32_t n_start, const uint32_t n_end, const uint32_t n_range) {
-            for (uint32_t i = n_start; i < n_end; ++i) {
-                for (uint32_t j = 1; j < n_range; ++j) {
-                    for (uint32_t k = 1; k < n_range; ++k) {
-                        if (i == (j * j * j) + (k * k * k)) {
-                            _queue.push({i, j, k});
-                        }
-                    }
-                }
-            }
+        virtual void find_taxicab_number(const uint64_t n_start, const uint64_t n_end, const uint32_t n_range) {
+            search_taxicab_number(n_start, n_end, n_range, [this](const CubeSum& ta) { _queue->push(std::get<0>(ta), ta); });
         }
 
-        virtual void save_taxicab_number(bool& loop) = 0;
+        // one producer, pulls chunks of the engine's range until none are left
+        virtual void produce() {
+            produce_chunks([this](const CubeSum& ta) { _queue->push(std::get<0>(ta), ta); });
+        }
+
+        // one consumer, owns the shard of the numbers in its partition
+        virtual void save_taxicab_number(std::atomic<bool>& loop, std::size_t shard) = 0;
+
+        // called before the consumers start, one shard per consumer
+        virtual void resize_shards(std::size_t shards) = 0;
 
         virtual void report_taxicab_number(int rank) = 0;
 
+        // visits every saved {i, a, b} of all shards, for a checkpoint
+        virtual void snapshot(const std::function<void(const CubeSum&)>& visit) = 0;
+
+        // with checkpoints the run goes in segments of about the interval:
+        // the producers finish their chunks, the consumers drain, then the state is saved
         virtual void run() {
-            std::thread consumer_thread;
-            std::thread worker_thread;
+            if (answer_from_cache()) {
+                return;
+            }
 
-            _t_start = std::chrono::steady_clock::now();
+            _t_start = std::chrono::steady_clock::now() - _resumed_elapsed;
+            start_chunks();
+            resize_shards(_C);
 
-            // single consumer thread
-            consumer_thread = std::thread{&Base::save_taxicab_number, this, std::ref(_loop)};
-            consumer_thread.detach();
+            // the sums of a checkpoint are saved again by their consumers
+            for (const CubeSum& ta : _resumed) {
+                _queue->push(std::get<0>(ta), ta);
+            }
+            _resumed.clear();
+            _resumed.shrink_to_fit();
+
+            bool done = false;
+            _segmented = true;
+
+            while (!done) {
+                std::vector<std::thread> consumer_threads;
+                std::vector<std::thread> worker_threads;
+
+                _loop = true;
+                _segment_end = _checkpoint > std::chrono::milliseconds::zero()
+                    ? std::chrono::steady_clock::now() + _checkpoint
+                    : std::chrono::steady_clock::time_point::max();
+
+                // one or more consumer threads, each on its own partition
+                for (uint32_t c = 0; c < _C; ++c) {
+                    consumer_threads.push_back(std::thread{&Base::save_taxicab_number, this, std::ref(_loop), c});
+                }
+
+                // one or more producer threads, all at the same time
+                for (uint32_t i = 0; i < _T; ++i) {
+                    worker_threads.push_back(std::thread{&Base::produce, this});
+                }
+
+                for (auto& worker_thread : worker_threads) {
+                    worker_thread.join();
+                }
 
-            // one or more producer threads
-            for (int i = 0; i < _T; ++i) {
-                uint32_t n_start = i * (_N / _T) + 1;
-                uint32_t n_end = (i + 1) * (_N / _T) + 1;
+                _t_end = std::chrono::steady_clock::now();
+                done = _chunks.done();
 
-                worker_thread = std::thread{&Base::find_taxicab_number, this, n_start, n_end, _R};
-                worker_thread.join();
+                // the consumers drain their partitions, then return
+                _loop = false;
+                for (auto& consumer_thread : consumer_threads) {
+                    consumer_thread.join();
+                }
+
+                if (!done && (_checkpoint > std::chrono::milliseconds::zero() || _stop)) {
+                    _util.save_checkpoint();
+                }
+
+                if (_stop) {
+                    break;
+                }
             }
 
-            _t_end = std::chrono::steady_clock::now();
+            _segmented = false;
+
+            // stopped, the checkpoint is the result
+            if (!done) {
+                return;
+            }
 
-            // terminate the detached consumer thread
-            _loop = false;
-            // must sleep more than queue's wait_and_pop_while() duration for a guaranteed graceful exit
-            std::this_thread::sleep_for(_timeout + _check);
             // report taxicab numbers with at least this rank
             report_taxicab_number(2);
+
+            if (_checkpoint > std::chrono::milliseconds::zero()) {
+                std::remove(checkpoint_file().c_str());
+            }
+        }
+
+        // the state is saved every interval of run(), zero turns checkpoints off;
+        // a segment ends with the producers' chunks in progress, the consumers' drain and about one check interval
+        virtual void checkpoint_interval(std::chrono::milliseconds interval) {
+            _checkpoint = interval;
+        }
+
+        // ends run() after the chunks in progress with a checkpoint and without a report,
+        // only stores a lock-free flag so a signal handler may call it
+        virtual void stop() {
+            _stop = true;
+        }
+
+        // loads the checkpoint of a run of the same N, R, T and engine, the next run() continues it
+        virtual bool resume() {
+            return _util.load_checkpoint();
+        }
+
+        // continues the binary result file of a run with N_old <= N and R_old <= R: its taxicab numbers are kept,
+        // the search covers (N_old, N] and the sums up to N_old of the cubes in [R_old, R)
+        virtual bool extend(const std::string& file_name) {
+            return _util.load_results(file_name);
+        }
+
+        virtual std::string checkpoint_file() const {
+            return _output_dir + "/" + _prefix + "checkpoint.bin";
         }
 
         virtual void dump_taxicab_number(int rank, std::size_t size_all, std::size_t size_tc) {
-            if (_json) {
+            if (_binary) {
+                _util.dump_binary_taxicab_number(rank, size_all, size_tc);
+            } else if (_json) {
                 _util.dump_json_taxicab_number(rank, size_all, size_tc);
             } else {
                 _util.dump_txt_taxicab_number(rank, size_all, size_tc);
             }
+
+            save_to_cache(rank, size_all, size_tc);
+        }
+
+        // finished runs are saved to dir, a run of a cached N and R or of a smaller one is answered from the cache,
+        // an empty dir turns the cache off
+        virtual void cache_dir(const std::string& dir) {
+            _cache_dir = dir;
+        }
+
+        // the last run was answered from the cache
+        virtual bool from_cache() const {
+            return _from_cache;
         }
 
         virtual void display_filename(bool on_off) {
@@ -114,32 +493,518 @@ class Base {
             _json = on_off;
         }
 
+        // the binary format of taxicab_reader.h instead of json or txt
+        virtual void write_binary(bool on_off) {
+            _binary = on_off;
+        }
+
+        // the path of the last report
+        virtual const std::string& report_file() const {
+            return _report_file;
+        }
+
+        virtual void search_engine(Engine engine) {
+            _engine = engine;
+        }
+
+        // the brute engine's kernel, a level above the CPU's falls back to the CPU's, returns the level in use
+        virtual SimdLevel simd_level(SimdLevel level) {
+            _simd = std::min(level, simd_detect());
+            return _simd;
+        }
+
+        virtual SimdLevel simd_level() const {
+            return _simd;
+        }
+
+        // the sums are partitioned by i, the output does not depend on the count
+        virtual void consumer_threads(uint32_t C) {
+            _C = C > 0 ? C : 1;
+            _queue.reset(new CubeQueue{_C});
+        }
+
+        // all numbers with cubes, the heap and window engines count them instead of storing them;
+        // an extended run adds the count of the earlier run for the sums it did not store again
+        virtual std::size_t size_all(std::size_t stored) {
+            if (_engine == Engine::heap || _engine == Engine::window) {
+                return _sum_count.load() + _extend_cubes;
+            }
+
+            return stored - _extend_stored + _extend_cubes;
+        }
+
         virtual std::vector<TaxiCab>& found() {
             return _taxicab;
         }
 
         virtual void clear() {
-            _queue.clear();
+            _queue->clear();
             _taxicab.clear();
+            _sum_count = 0;
             _loop = true;
+            _stop = false;
+            _resumed.clear();
+            _resumed_next = 0;
+            _resumed_elapsed = std::chrono::milliseconds::zero();
+            _N_low = 0;
+            _extend_cubes = 0;
+            _extend_stored = 0;
         }
 
         friend class Utility;
 
     protected:
-        const uint32_t _N;
+        // the search itself, emit(CubeSum) receives every sum of two cubes in [n_start, n_end)
+        template<typename Emit>
+        static void search_taxicab_number(const uint64_t n_start, const uint64_t n_end, const uint32_t n_range, Emit emit) {
+            for (uint64_t i = n_start; i < n_end; ++i) {
+                for (uint32_t j = 1; j < n_range; ++j) {
+                    for (uint32_t k = 1; k < n_range; ++k) {
+                        if (i == (uint64_t{j} * j * j) + (uint64_t{k} * k * k)) {
+                            emit(CubeSum{i, j, k});
+                        }
+                    }
+                }
+            }
+        }
+
+        // every a in [a_start, a_end) and a <= b < n_range with n_low < a^3 + b^3 <= n_max, each sum once as {a^3 + b^3, a, b}
+        template<typename Emit>
+        static void search_taxicab_pairs(const uint64_t a_start, const uint64_t a_end, const uint64_t n_low, const uint64_t n_max, const uint32_t n_range, Emit emit) {
+            for (uint64_t a = a_start; a < a_end && a < n_range; ++a) {
+                uint64_t a3 = a * a * a;
+
+                if (a3 > n_max || a3 > n_max - a3) {      // 2 a^3 > n_max, no b >= a left
+                    break;
+                }
+
+                uint64_t b_start = a;
+
+                // the first b with a sum above n_low
+                if (a3 + a3 <= n_low) {
+                    b_start = std::max(a, cube_root(n_low - a3));
+                    while (a3 + b_start * b_start * b_start <= n_low) {
+                        ++b_start;
+                    }
+                }
+
+                for (uint64_t b = b_start; b < n_range; ++b) {
+                    uint64_t b3 = b * b * b;
+
+                    if (b3 > n_max - a3) {
+                        break;
+                    }
+
+                    emit(CubeSum{a3 + b3, static_cast<uint32_t>(a), static_cast<uint32_t>(b)});
+                }
+            }
+        }
+
+        // the sums in (n_low, n_high] in increasing order from a min-heap of one frontier (a, b) per a,
+        // equal sums are adjacent: only groups of two or more pairs are emitted, returns the number of distinct sums
+        template<typename Emit>
+        static uint64_t search_taxicab_heap(const uint64_t n_low, const uint64_t n_high, const uint32_t n_range, Emit emit) {
+            struct Frontier {
+                uint64_t sum;
+                uint32_t a;
+                uint32_t b;
+            };
+
+            auto later = [](const Frontier& x, const Frontier& y) { return x.sum > y.sum; };
+            std::vector<Frontier> heap{};
+            std::vector<Frontier> group{};
+            uint64_t count = 0;
+
+            for (uint64_t a = 1; a < n_range && 2 * a * a * a <= n_high; ++a) {
+                uint64_t a3 = a * a * a;
+                uint64_t b = a;
+
+                // the first b with a sum above n_low
+                if (a3 + b * b * b <= n_low) {
+                    b = std::max(a, cube_root(n_low - a3));
+                    while (a3 + b * b * b <= n_low) {
+                        ++b;
+                    }
+                }
+
+                if (b < n_range && a3 + b * b * b <= n_high) {
+                    heap.push_back(Frontier{a3 + b * b * b, static_cast<uint32_t>(a), static_cast<uint32_t>(b)});
+                }
+            }
+
+            std::make_heap(heap.begin(), heap.end(), later);
+
+            while (!heap.empty()) {
+                uint64_t sum = heap.front().sum;
+                group.clear();
+
+                while (!heap.empty() && heap.front().sum == sum) {
+                    std::pop_heap(heap.begin(), heap.end(), later);
+                    Frontier f = heap.back();
+                    heap.pop_back();
+                    group.push_back(f);
+
+                    // the next sum of this a
+                    uint64_t a = f.a;
+                    uint64_t b = f.b + 1;
+                    uint64_t next = a * a * a + b * b * b;
+
+                    if (b < n_range && next <= n_high) {
+                        heap.push_back(Frontier{next, f.a, static_cast<uint32_t>(b)});
+                        std::push_heap(heap.begin(), heap.end(), later);
+                    }
+                }
+
+                ++count;
+
+                if (group.size() >= 2) {
+                    for (const Frontier& f : group) {
+                        emit(CubeSum{sum, f.a, f.b});
+                    }
+                }
+            }
+
+            return count;
+        }
+
+        // windows [w_start, w_end) of WINDOW numbers in (n_low, n_max], window w holds the sums in [w WINDOW, (w + 1) WINDOW):
+        // a window counts its sums in a dense array of uint8_t, then emits the pairs of the sums counted twice or more,
+        // a pair (a, b) waits in the list of the window of its next sum, returns the number of distinct sums;
+        // only the counters of the window's pairs are read and reset, sparse windows far up cost their pairs, not WINDOW
+        template<typename Emit>
+        static uint64_t search_taxicab_window(const uint64_t w_start, const uint64_t w_end, const uint64_t n_low, const uint64_t n_max, const uint32_t n_range, Emit emit) {
+            // a thread's buffers outlive its chunks: the counters are zero and the lists empty between calls,
+            // the lists keep their capacity so small chunks cost no allocations
+            static thread_local std::vector<uint8_t> count(WINDOW, 0);
+            static thread_local std::vector<std::vector<CubePair>> due(WINDOW_SLAB);
+            uint64_t distinct = 0;
+
+            // the lists of a slab are filled at its start, a cube root per a
+            for (uint64_t slab = w_start; slab < w_end; slab += WINDOW_SLAB) {
+                uint64_t slab_end = std::min(w_end, slab + WINDOW_SLAB);
+                uint64_t slab_lo = std::max(slab * WINDOW, n_low + 1);
+                uint64_t slab_hi = std::min(slab_end * WINDOW, n_max + 1);
+
+                for (uint64_t a = 1; a < n_range && 2 * a * a * a < slab_hi; ++a) {
+                    uint64_t a3 = a * a * a;
+                    uint64_t b = a;
+
+                    // the first b with a sum in the slab
+                    if (a3 + b * b * b < slab_lo) {
+                        b = std::max(a, cube_root(slab_lo - a3));
+                        while (a3 + b * b * b < slab_lo) {
+                            ++b;
+                        }
+                    }
+
+                    uint64_t sum = a3 + b * b * b;
+                    if (b < n_range && sum < slab_hi) {
+                        due[sum / WINDOW - slab].push_back(CubePair{static_cast<uint32_t>(a), static_cast<uint32_t>(b)});
+                    }
+                }
+
+                for (uint64_t w = slab; w < slab_end; ++w) {
+                    uint64_t lo = w * WINDOW;
+                    uint64_t hi = std::min(lo + WINDOW, slab_hi);
+                    auto& pairs = due[w - slab];
+
+                    // count, then hand the pair on to the window of its next sum
+                    for (const CubePair& ab : pairs) {
+                        uint64_t a = ab.first;
+                        uint64_t a3 = a * a * a;
+                        uint64_t b = ab.second;
+                        uint64_t sum = a3 + b * b * b;
+
+                        for (; b < n_range && sum < hi; ++b, sum = a3 + b * b * b) {
+                            uint8_t& c = count[sum - lo];
+                            if (c == 0) {
+                                ++distinct;
+                            }
+                            if (c < 2) {
+                                ++c;
+                            }
+                        }
+
+                        if (b < n_range && sum < slab_hi) {
+                            due[sum / WINDOW - slab].push_back(CubePair{ab.first, static_cast<uint32_t>(b)});
+                        }
+                    }
+
+                    for (const CubePair& ab : pairs) {
+                        uint64_t a = ab.first;
+                        uint64_t a3 = a * a * a;
+                        uint64_t b = ab.second;
+                        uint64_t sum = a3 + b * b * b;
+
+                        for (; b < n_range && sum < hi; ++b, sum = a3 + b * b * b) {
+                            if (count[sum - lo] >= 2) {
+                                emit(CubeSum{sum, ab.first, static_cast<uint32_t>(b)});
+                            }
+                        }
+                    }
+
+                    for (const CubePair& ab : pairs) {
+                        uint64_t a = ab.first;
+                        uint64_t a3 = a * a * a;
+                        uint64_t b = ab.second;
+                        uint64_t sum = a3 + b * b * b;
+
+                        for (; b < n_range && sum < hi; ++b, sum = a3 + b * b * b) {
+                            count[sum - lo] = 0;
+                        }
+                    }
+
+                    pairs.clear();
+                }
+            }
+
+            return distinct;
+        }
+
+        // the sums up to n_max of the pairs a <= b < n_range with b >= r_old, which a run with the cube range r_old missed,
+        // each with the pairs of that run of the same sum, found by cube roots; returns the number of sums new to that run
+        template<typename Emit>
+        static uint64_t search_taxicab_grown(const uint64_t n_max, const uint32_t r_old, const uint32_t n_range, Emit emit) {
+            std::vector<CubeSum> grown{};
+            std::size_t size = 0;
+
+            // the pairs of a grown b are counted first, the vector is allocated once
+            for (uint64_t b = std::max<uint32_t>(r_old, 1); b < n_range && b * b * b < n_max; ++b) {
+                size += static_cast<std::size_t>(std::min<uint64_t>(b, cube_root(n_max - b * b * b)));
+            }
+            grown.reserve(size);
+
+            for (uint64_t b = std::max<uint32_t>(r_old, 1); b < n_range && b * b * b < n_max; ++b) {
+                uint64_t b3 = b * b * b;
+
+                for (uint64_t a = 1; a <= b && a * a * a <= n_max - b3; ++a) {
+                    grown.push_back(CubeSum{a * a * a + b3, static_cast<uint32_t>(a), static_cast<uint32_t>(b)});
+                }
+            }
+
+            std::sort(grown.begin(), grown.end());
+            uint64_t fresh = 0;
+
+            for (std::size_t g = 0; g < grown.size(); ) {
+                uint64_t sum = std::get<0>(grown[g]);
+                bool found = false;
+
+                for (; g < grown.size() && std::get<0>(grown[g]) == sum; ++g) {
+                    emit(grown[g]);
+                }
+
+                for (uint64_t a = 1; a < r_old && 2 * a * a * a <= sum; ++a) {
+                    uint64_t rest = sum - a * a * a;
+                    uint64_t b = cube_root(rest);
+
+                    if (b < r_old && b * b * b == rest) {
+                        emit(CubeSum{sum, static_cast<uint32_t>(a), static_cast<uint32_t>(b)});
+                        found = true;
+                    }
+                }
+
+                if (!found) {
+                    ++fresh;
+                }
+            }
+
+            return fresh;
+        }
+
+        // heap chunk k of HEAP_CHUNKS_PER_THREAD * T takes the sums in (heap_bound(k), heap_bound(k + 1)] of (N_low, N],
+        // there are about x^(2/3) sums up to x so the chunks are of about equal work
+        uint64_t heap_bound(const uint64_t k) const {
+            uint64_t chunks = HEAP_CHUNKS_PER_THREAD * _T;
+
+            if (k == 0) {
+                return _N_low;
+            }
+
+            if (k >= chunks) {
+                return _N;
+            }
+
+            double low = std::pow(static_cast<double>(_N_low), 2.0 / 3);
+            double high = std::pow(static_cast<double>(_N), 2.0 / 3);
+            uint64_t bound = static_cast<uint64_t>(std::pow(low + (high - low) * k / chunks, 1.5));
+
+            return std::min(_N, std::max(_N_low, bound));
+        }
+
+        // the range the producers share: numbers for brute, a for pairs, heap chunks for heap, windows for window
+        void start_chunks() {
+            // with checkpoints a chunk is a small share of the range, a segment ends soon after its interval
+            auto max_chunk = [this](const uint64_t first, const uint64_t last) {
+                return _checkpoint > std::chrono::milliseconds::zero() ? (last - first) / CHECKPOINT_CHUNKS : UINT64_MAX;
+            };
+
+            if (_engine == Engine::pairs) {
+                // no b >= a is left once 2 a^3 > N
+                uint64_t a_end = std::min<uint64_t>(_R, cube_root(_N / 2) + 1);
+                _chunks.reset(1, a_end, _T, 1, max_chunk(1, a_end));
+            } else if (_engine == Engine::heap) {
+                _chunks.reset(0, HEAP_CHUNKS_PER_THREAD * _T, _T, 1, max_chunk(0, HEAP_CHUNKS_PER_THREAD * _T));
+            } else if (_engine == Engine::window) {
+                _chunks.reset(_N_low / WINDOW, _N / WINDOW + 1, _T, 1, max_chunk(_N_low / WINDOW, _N / WINDOW + 1));
+            } else {
+                _chunks.reset(_N_low + 1, _N + 1, _T, BRUTE_MIN_CHUNK, max_chunk(_N_low + 1, _N + 1));
+                _kernel.reset(_R, _simd);
+            }
+
+            _chunks.advance(_resumed_next);
+        }
+
+        // fills _taxicab from a cached run and reports it
+        bool answer_from_cache() {
+            _from_cache = false;
+
+            if (_cache_dir.empty()) {
+                return false;
+            }
+
+            std::size_t size_all = 0;
+            _t_start = std::chrono::steady_clock::now();
+
+            if (!_util.load_cache(size_all)) {
+                return false;
+            }
+
+            _t_end = std::chrono::steady_clock::now();
+            _from_cache = true;
+            dump_taxicab_number(2, size_all, _taxicab.size());
+
+            return true;
+        }
+
+        void save_to_cache(const int rank, const std::size_t size_all, const std::size_t size_tc) {
+            if (!_cache_dir.empty() && !_from_cache) {
+                _util.save_cache(rank, size_all, size_tc);
+            }
+        }
+
+        // the producers of a segment take no more chunks
+        bool segment_over() const {
+            return _segmented && (_stop || std::chrono::steady_clock::now() >= _segment_end);
+        }
+
+        // the body of a producer thread, emit(CubeSum) receives what its chunks find
+        template<typename Emit>
+        void produce_chunks(Emit emit) {
+            uint64_t start = 0;
+            uint64_t end = 0;
+
+            while (!segment_over() && _chunks.next(start, end)) {
+                if (_engine == Engine::pairs) {
+                    search_taxicab_pairs(start, end, _N_low, _N, _R, emit);
+                } else if (_engine == Engine::heap) {
+                    _sum_count += search_taxicab_heap(heap_bound(start), heap_bound(end), _R, emit);
+                } else if (_engine == Engine::window) {
+                    _sum_count += search_taxicab_window(start, end, _N_low, _N, _R, emit);
+                } else {
+                    // every level runs the kernel's loop, scalar included
+                    _kernel.search(start, end, [&emit](const uint64_t i, const uint32_t j, const uint32_t k) {
+                        emit(CubeSum{i, j, k});
+                    });
+                }
+            }
+        }
+
+        // the next sum of a consumer's partition, false once the producers are done and the partition is drained;
+        // the wait is cut into check intervals, so a drained consumer returns within one of the producers' end
+        bool next_sum(const std::atomic<bool>& loop, std::size_t shard, CubeSum& ta) {
+            while (true) {
+                // read before the pop: once false, every push of the segment is in the partition
+                bool more = loop.load();
+
+                if (_queue->wait_and_pop_while(shard, ta, _check, _check)) {
+                    return true;
+                }
+                if (!more) {
+                    return false;
+                }
+            }
+        }
+
+        // visits the entries of all shards in ascending key order with their shard, a shard's keys are its own
+        template<typename Map, typename Visit>
+        static void merge_shards(const std::vector<Map>& shards, Visit visit) {
+            using Cursor = std::pair<typename Map::const_iterator, std::size_t>;
+            auto later = [](const Cursor& x, const Cursor& y) { return x.first->first > y.first->first; };
+            std::vector<Cursor> heap;
+
+            for (std::size_t s = 0; s < shards.size(); ++s) {
+                if (!shards[s].empty()) {
+                    heap.push_back(Cursor{shards[s].cbegin(), s});
+                }
+            }
+            std::make_heap(heap.begin(), heap.end(), later);
+
+            while (!heap.empty()) {
+                std::pop_heap(heap.begin(), heap.end(), later);
+                Cursor& cursor = heap.back();
+                visit(*cursor.first, cursor.second);
+
+                if (++cursor.first != shards[cursor.second].cend()) {
+                    std::push_heap(heap.begin(), heap.end(), later);
+                } else {
+                    heap.pop_back();
+                }
+            }
+        }
+
+        template<typename Map>
+        static std::size_t shards_size(const std::vector<Map>& shards) {
+            std::size_t n = 0;
+
+            for (auto& shard : shards) {
+                n += shard.size();
+            }
+
+            return n;
+        }
+
+        static const uint64_t BRUTE_MIN_CHUNK = 64;
+        static const uint64_t HEAP_CHUNKS_PER_THREAD = 8;
+        // 256 KiB of uint8_t counters stay in L2
+        static const uint64_t WINDOW = 1 << 18;
+        // windows that share one pass of cube roots
+        static const uint64_t WINDOW_SLAB = 1024;
+        // the smallest share of a range in a chunk when checkpointing
+        static const uint64_t CHECKPOINT_CHUNKS = 4096;
+
+        const uint64_t _N;
+        uint64_t _N_low = 0;                                // an extended run searches (N_low, N]
         const uint32_t _R;
         const uint32_t _T;
-        std::chrono::milliseconds _timeout;
+        uint32_t _C = 1;
+        std::chrono::milliseconds _timeout;                 // of the interface, consumers wait in check intervals
         const std::chrono::milliseconds _check;
         std::string _prefix;
-        bool _loop = true;
-        ConcurrentQueue<std::tuple<uint32_t, uint32_t, uint32_t>> _queue{};
+        std::atomic<bool> _loop{true};                     // false once a segment's producers are done
+        Engine _engine = Engine::brute;
+        SimdLevel _simd = simd_detect();
+        CubeKernel _kernel{};
+        std::atomic<uint64_t> _sum_count{0};
+        ChunkCursor _chunks{};
+        std::unique_ptr<CubeQueue> _queue{new CubeQueue{1}};
         std::chrono::time_point<std::chrono::steady_clock> _t_start;
         std::chrono::time_point<std::chrono::steady_clock> _t_end;
         std::string _output_dir = "output";
         bool _display = true;
         bool _json = true;
+        bool _binary = false;
+        std::string _report_file{};
+        std::chrono::milliseconds _checkpoint{0};
+        std::chrono::steady_clock::time_point _segment_end = std::chrono::steady_clock::time_point::max();
+        bool _segmented = false;
+        std::atomic<bool> _stop{false};
+        std::vector<CubeSum> _resumed{};                    // the sums of a loaded checkpoint
+        uint64_t _resumed_next = 0;
+        std::chrono::milliseconds _resumed_elapsed{0};
+        uint64_t _extend_cubes = 0;                         // numbers with cubes of the earlier run and the grown cubes
+        std::size_t _extend_stored = 0;                     // numbers up to N_low in _resumed, stored again
+        std::string _cache_dir{};
+        bool _from_cache = false;
         std::vector<TaxiCab> _taxicab;
         Utility _util{this};
 };
@@ -147,35 +1012,92 @@ class Base {
 // save taxicab number's cubes in std::string
 class TaxiCabNumberStr : public Base {
     public:
-        TaxiCabNumberStr(uint32_t N,
+        TaxiCabNumberStr(uint64_t N,
                          uint32_t R,
                          uint32_t T,
                          std::chrono::milliseconds& timeout,
-                         std::chrono::milliseconds& check) : Base(N, R, T, timeout, check, "str_") {}
-        void save_taxicab_number(bool& loop) override;
+                         std::chrono::milliseconds& check) : Base(N, R, T, timeout, check, "str_"), _cube(1) {}
+        void save_taxicab_number(std::atomic<bool>& loop, std::size_t shard) override;
+        void resize_shards(std::size_t shards) override;
         void report_taxicab_number(const int rank) override;
+        void snapshot(const std::function<void(const CubeSum&)>& visit) override;
         void clear() override;
 
     private:
         std::vector<std::string> split(const std::string& s, const char delimiter);
-        std::map<uint32_t, std::string> _cube{};
+        std::vector<std::map<uint64_t, std::string>> _cube;
 };
 
-// save taxicab number's cubes in the bits of an uint64_t
+// save taxicab number's cubes in the bits of an uint64_t, see PackedPairs
 class TaxiCabNumberInt : public Base {
     public:
-        TaxiCabNumberInt(uint32_t N,
+        TaxiCabNumberInt(uint64_t N,
                          uint32_t R,
                          uint32_t T,
                          std::chrono::milliseconds& timeout,
-                         std::chrono::milliseconds& check) : Base(N, R, T, timeout, check, "int_") {}
-        void save_taxicab_number(bool& loop) override;
+                         std::chrono::milliseconds& check) : Base(N, R, T, timeout, check, "int_"), _cube(1), _pairs(1, PackedPairs{R}) {}
+        void save_taxicab_number(std::atomic<bool>& loop, std::size_t shard) override;
+        void resize_shards(std::size_t shards) override;
+        void report_taxicab_number(const int rank) override;
+        void snapshot(const std::function<void(const CubeSum&)>& visit) override;
+        void clear() override;
+
+    private:
+        std::vector<std::map<uint64_t, uint64_t>> _cube;
+        std::vector<PackedPairs> _pairs;                // the arena of each shard
+};
+
+// save taxicab number's cubes inline in the slots of an open-addressing hash table
+class TaxiCabNumberFlat : public Base {
+    public:
+        TaxiCabNumberFlat(uint64_t N,
+                          uint32_t R,
+                          uint32_t T,
+                          std::chrono::milliseconds& timeout,
+                          std::chrono::milliseconds& check) : Base(N, R, T, timeout, check, "flat_"), _cube(1) {}
+        void save_taxicab_number(std::atomic<bool>& loop, std::size_t shard) override;
+        void resize_shards(std::size_t shards) override;
         void report_taxicab_number(const int rank) override;
+        void snapshot(const std::function<void(const CubeSum&)>& visit) override;
         void clear() override;
 
     private:
-        std::vector<uint16_t> split(const uint64_t x);
-        std::map<uint32_t, uint64_t> _cube{};
+        std::vector<CubeTable> _cube;
+};
+
+// search -> aggregate -> format -> write as a Pipeline
+class TaxiCabNumberPipe : public Base {
+    public:
+        TaxiCabNumberPipe(uint64_t N,
+                          uint32_t R,
+                          uint32_t T,
+                          std::chrono::milliseconds& timeout,
+                          std::chrono::milliseconds& check) : Base(N, R, T, timeout, check, "pipe_"), _cube(1) {}
+        void save_taxicab_number(std::atomic<bool>& loop, std::size_t shard) override;
+        void resize_shards(std::size_t shards) override;
+        void report_taxicab_number(const int rank) override;
+        void snapshot(const std::function<void(const CubeSum&)>& visit) override;
+        void run() override;
+        void clear() override;
+
+        // search runs on T threads, aggregate on the consumer threads, write on one thread
+        void aggregate_threads(uint32_t threads);
+        void format_threads(uint32_t threads);
+        std::vector<PipelineStats>& stats();
+
+    private:
+        // the n-th taxicab number for the format stage, points into _taxicab
+        using Found = std::pair<uint64_t, const TaxiCab*>;
+        // formatted entries wait for their turn in a window of this many per format thread
+        static const std::size_t FORMAT_WINDOW = 64;
+
+        void aggregate(const CubeSum& ta, std::size_t shard);
+        void collect(const int rank);
+
+        uint32_t _format_threads = 1;
+        std::vector<PipelineStats> _stats{};
+        // a shard per aggregate thread, a number's sums all go to the shard of i % threads
+        std::vector<std::map<uint64_t, std::vector<CubePair>>> _cube;
 };
 
 
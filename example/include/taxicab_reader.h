@@ -0,0 +1,177 @@
+#ifndef TAXICAB_READER_H
+#define TAXICAB_READER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <algorithm>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * Binary result file
+ *
+ * A header, the sorted taxicab numbers, an offsets array into the pairs and
+ * the packed pairs, in the byte order of the machine that wrote them:
+ *
+ *      TaxiCabFileHeader
+ *      uint64_t sums[total_taxicabs]                   ascending
+ *      uint64_t offsets[total_taxicabs + 1]            pairs of sums[i]: [offsets[i], offsets[i + 1])
+ *      uint32_t pairs[2 * total_pairs]                 a, b with a <= b, ascending per sum
+ *
+ * Every array starts at a multiple of 8 bytes, so a mapped file is used in place.
+ * see:
+ *      https://man7.org/linux/man-pages/man2/mmap.2.html
+ */
+
+struct TaxiCabFileHeader {
+    char magic[8];                                      // "TAXICAB"
+    uint32_t version;
+    uint32_t rank;                                      // taxicab numbers of at least this many pairs
+    uint64_t n;
+    uint64_t r;
+    uint64_t t;
+    uint64_t total_cubes;                               // all numbers with cubes
+    uint64_t total_taxicabs;
+    uint64_t total_pairs;
+    uint64_t elapsed_ms;
+};
+
+static const char TAXICAB_FILE_MAGIC[8] = "TAXICAB";
+static const uint32_t TAXICAB_FILE_VERSION = 1;
+
+// read-only view of a mapped result file, lookups do not copy
+class TaxiCabReader {
+    public:
+        // the pairs of one taxicab number, pairs[2 i] <= pairs[2 i + 1]
+        struct Entry {
+            uint64_t sum;
+            const uint32_t* pairs;
+            std::size_t count;
+        };
+
+        TaxiCabReader() = default;                                      // default constructor
+        TaxiCabReader(const TaxiCabReader&) = delete;                   // copy constructor
+        TaxiCabReader& operator=(const TaxiCabReader&) = delete;        // copy assignment
+
+        ~TaxiCabReader() {
+            close();
+        }
+
+        // false if the file cannot be mapped or is not a complete result file
+        bool open(const std::string& file_name) {
+            close();
+
+            int fd = ::open(file_name.c_str(), O_RDONLY);
+            if (fd < 0) {
+                return false;
+            }
+
+            struct stat st;
+            if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(TaxiCabFileHeader)) {
+                ::close(fd);
+                return false;
+            }
+
+            void* data = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+
+            if (data == MAP_FAILED) {
+                return false;
+            }
+
+            _data = static_cast<const char*>(data);
+            _length = st.st_size;
+
+            if (!valid()) {
+                close();
+                return false;
+            }
+
+            _header = reinterpret_cast<const TaxiCabFileHeader*>(_data);
+            _sums = reinterpret_cast<const uint64_t*>(_data + sizeof(TaxiCabFileHeader));
+            _offsets = _sums + _header->total_taxicabs;
+            _pairs = reinterpret_cast<const uint32_t*>(_offsets + _header->total_taxicabs + 1);
+
+            return true;
+        }
+
+        void close() {
+            if (_data != nullptr) {
+                ::munmap(const_cast<char*>(_data), _length);
+            }
+
+            _data = nullptr;
+            _length = 0;
+            _header = nullptr;
+        }
+
+        bool is_open() const {
+            return _data != nullptr;
+        }
+
+        const TaxiCabFileHeader& header() const {
+            return *_header;
+        }
+
+        std::size_t size() const {
+            return _header->total_taxicabs;
+        }
+
+        Entry at(const std::size_t i) const {
+            return Entry{_sums[i], _pairs + 2 * _offsets[i], static_cast<std::size_t>(_offsets[i + 1] - _offsets[i])};
+        }
+
+        // binary search over the sums, size() if sum is not a taxicab number of the file
+        std::size_t find(const uint64_t sum) const {
+            const uint64_t* end = _sums + size();
+            const uint64_t* it = std::lower_bound(_sums, end, sum);
+
+            return it != end && *it == sum ? static_cast<std::size_t>(it - _sums) : size();
+        }
+
+    private:
+        // the arrays fit in the file and the offsets are in order
+        bool valid() const {
+            const TaxiCabFileHeader* header = reinterpret_cast<const TaxiCabFileHeader*>(_data);
+
+            if (std::memcmp(header->magic, TAXICAB_FILE_MAGIC, sizeof(header->magic)) != 0 || header->version != TAXICAB_FILE_VERSION) {
+                return false;
+            }
+
+            uint64_t count = header->total_taxicabs;
+            uint64_t pairs = header->total_pairs;
+            uint64_t room = (_length - sizeof(TaxiCabFileHeader)) / sizeof(uint64_t);
+
+            // overflow-free form of (2 count + 1) 8 + 8 pairs <= _length - header
+            if (count > room / 2 || 2 * count + 1 > room || pairs > room - 2 * count - 1) {
+                return false;
+            }
+
+            const uint64_t* offsets = reinterpret_cast<const uint64_t*>(_data + sizeof(TaxiCabFileHeader)) + count;
+
+            if (offsets[0] != 0 || offsets[count] != pairs) {
+                return false;
+            }
+            for (uint64_t i = 0; i < count; ++i) {
+                if (offsets[i] > offsets[i + 1]) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        const char* _data = nullptr;
+        std::size_t _length = 0;
+        const TaxiCabFileHeader* _header = nullptr;
+        const uint64_t* _sums = nullptr;
+        const uint64_t* _offsets = nullptr;
+        const uint32_t* _pairs = nullptr;
+};
+
+#endif
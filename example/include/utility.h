@@ -1,7 +1,10 @@
 #ifndef UTILITY_H
 #define UTILITY_H
 
+#include "report_writer.h"
+
 class Base; // forward declaration
+struct TaxiCab;
 
 class Utility {
     public:
@@ -10,13 +13,26 @@ class Utility {
 
         std::string elapsed_time(std::chrono::milliseconds msecs);
         std::string gen_file_name();
-        void report_header(std::ostringstream& dump, const uint32_t rank, const std::size_t size_all, const std::size_t size_tc);
-        void report_footer(std::ostringstream& dump);
-        void report_meta(std::ostringstream& dump, const uint32_t rank, const std::size_t size_all, const std::size_t size_tc);
+        void report_header(ReportWriter& out, const uint32_t rank, const std::size_t size_all, const std::size_t size_tc);
+        void report_footer(ReportWriter& out);
+        void report_meta(ReportWriter& out, const uint32_t rank, const std::size_t size_all, const std::size_t size_tc);
+        void write_txt_taxicab(ReportWriter& out, const std::size_t index, const TaxiCab& tc);
+        void write_json_taxicab(ReportWriter& out, const TaxiCab& tc);
         void dump_txt_taxicab_number(const int rank, const std::size_t size_all, const std::size_t size_tc);
         void dump_json_taxicab_number(const int rank, const std::size_t size_all, const std::size_t size_tc);
-        void save_report(std::ostringstream& dump);
-        bool save_to_txt_file(const std::string& file_name, const std::string& content);
+        void dump_binary_taxicab_number(const int rank, const std::size_t size_all, const std::size_t size_tc);
+        bool begin_report(ReportWriter& out, const int rank, const std::size_t size_all, const std::size_t size_tc);
+        bool end_report(ReportWriter& out, const bool empty);
+        bool open_report(ReportWriter& out);
+        bool close_report(ReportWriter& out);
+        bool save_checkpoint();
+        bool load_checkpoint();
+        bool load_results(const std::string& file_name);
+        void write_binary(ReportWriter& out, const int rank, const std::size_t size_all, const std::size_t size_tc);
+        std::string cache_file_name(const uint64_t n, const uint64_t r);
+        uint64_t count_pairs(const uint64_t n_max, const uint64_t n_range);
+        bool load_cache(std::size_t& size_all);
+        bool save_cache(const int rank, const std::size_t size_all, const std::size_t size_tc);
 
     private:
         Base* _base;
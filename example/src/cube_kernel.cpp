@@ -0,0 +1,118 @@
+#include "../include/cube_kernel.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define CUBE_KERNEL_X86
+#include <immintrin.h>
+#endif
+
+const std::size_t CubeKernel::PAD;
+
+static std::size_t match_scalar(const uint64_t* cubes, const std::size_t n, const uint64_t target) {
+    for (std::size_t k = 0; k < n; ++k) {
+        if (cubes[k] == target) {
+            return k;
+        }
+    }
+
+    return n;
+}
+
+#ifdef CUBE_KERNEL_X86
+
+__attribute__((target("sse4.1")))
+static std::size_t match_sse41(const uint64_t* cubes, const std::size_t n, const uint64_t target) {
+    const __m128i t = _mm_set1_epi64x(static_cast<long long>(target));
+
+    for (std::size_t k = 0; k < n; k += 2) {
+        __m128i c = _mm_load_si128(reinterpret_cast<const __m128i*>(cubes + k));
+        int mask = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpeq_epi64(c, t)));
+
+        if (mask != 0) {
+            return k + __builtin_ctz(mask);
+        }
+    }
+
+    return n;
+}
+
+__attribute__((target("avx2")))
+static std::size_t match_avx2(const uint64_t* cubes, const std::size_t n, const uint64_t target) {
+    const __m256i t = _mm256_set1_epi64x(static_cast<long long>(target));
+
+    for (std::size_t k = 0; k < n; k += 8) {
+        __m256i c0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(cubes + k));
+        __m256i c1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(cubes + k + 4));
+        int mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(c0, t)))
+                 | _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(c1, t))) << 4;
+
+        if (mask != 0) {
+            return k + __builtin_ctz(mask);
+        }
+    }
+
+    return n;
+}
+
+__attribute__((target("avx512f")))
+static std::size_t match_avx512(const uint64_t* cubes, const std::size_t n, const uint64_t target) {
+    const __m512i t = _mm512_set1_epi64(static_cast<long long>(target));
+
+    for (std::size_t k = 0; k < n; k += 8) {
+        __m512i c = _mm512_load_si512(reinterpret_cast<const void*>(cubes + k));
+        __mmask8 mask = _mm512_cmpeq_epu64_mask(c, t);
+
+        if (mask != 0) {
+            return k + __builtin_ctz(mask);
+        }
+    }
+
+    return n;
+}
+
+#endif
+
+SimdLevel simd_detect() {
+#ifdef CUBE_KERNEL_X86
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f")) {
+        return SimdLevel::avx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::avx2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return SimdLevel::sse41;
+    }
+#endif
+    return SimdLevel::scalar;
+}
+
+const char* simd_name(const SimdLevel level) {
+    switch (level) {
+        case SimdLevel::sse41:
+            return "sse41";
+        case SimdLevel::avx2:
+            return "avx2";
+        case SimdLevel::avx512:
+            return "avx512";
+        default:
+            return "scalar";
+    }
+}
+
+CubeMatch simd_match(const SimdLevel level) {
+#ifdef CUBE_KERNEL_X86
+    switch (level) {
+        case SimdLevel::sse41:
+            return match_sse41;
+        case SimdLevel::avx2:
+            return match_avx2;
+        case SimdLevel::avx512:
+            return match_avx512;
+        default:
+            break;
+    }
+#endif
+    return match_scalar;
+}
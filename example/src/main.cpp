@@ -1,18 +1,30 @@
 #include <iostream>
 #include <iomanip>
 #include <cmath>
+#include <string>
+#include <vector>
+#include <csignal>
 
 #include "../include/taxicab_number.h"
 
+// Ctrl-C ends a checkpointed run with a last checkpoint
+static Base* running = nullptr;
+
+extern "C" void stop_running(int) {
+    if (running != nullptr) {
+        running->stop();
+    }
+}
+
 int main(int argc, char **argv) {
     int p = 0;
     int p_min = 4;
-    int p_max = 10;
+    int p_max = 18;
     int p_def = 5;
-    uint32_t N = 0;
+    uint64_t N = 0;
     int r = 0;
     int r_min = 1;
-    int r_max = 3;
+    int r_max = 6;
     int r_def = 2;
     uint32_t R = 0;
     uint32_t T = 0;
@@ -20,14 +32,105 @@ int main(int argc, char **argv) {
     uint32_t t_max = 1024;
     uint32_t t_def = t_min;
     const int width = 36;
+    Engine engine = Engine::brute;
+    std::string engine_name = "brute";
+    uint32_t C = 1;
+    SimdLevel simd = simd_detect();
+    bool binary = false;
+    uint32_t checkpoint = 0;
+    bool resume = false;
+    std::string extend{};
+    std::string cache{};
+
+    // flags may come anywhere, the remaining arguments are positional
+    std::vector<char*> args{argv[0]};
+    for (int a = 1; a < argc; ++a) {
+        std::string arg{argv[a]};
+
+        if (arg.compare(0, 9, "--engine=") == 0) {
+            engine_name = arg.substr(9);
+
+            if (engine_name == "brute") {
+                engine = Engine::brute;
+            } else if (engine_name == "pairs") {
+                engine = Engine::pairs;
+            } else if (engine_name == "heap") {
+                engine = Engine::heap;
+            } else if (engine_name == "window") {
+                engine = Engine::window;
+            } else {
+                std::cerr << "ERROR: unknown search engine: " << engine_name << ", expected brute, pairs, heap or window\n";
+                return 13;
+            }
+        } else if (arg.compare(0, 12, "--consumers=") == 0) {
+            try {
+                C = std::stoul(arg.substr(12));
+            } catch (std::exception const &e) {
+                C = 0;
+            }
+            if (C < t_min || C > t_max) {
+                std::cerr << "ERROR: invalid consumer thread number: " << arg.substr(12) << ", expected 1 to " << t_max << '\n';
+                return 14;
+            }
+        } else if (arg == "--binary") {
+            binary = true;
+        } else if (arg.compare(0, 13, "--checkpoint=") == 0) {
+            try {
+                checkpoint = std::stoul(arg.substr(13));
+            } catch (std::exception const &e) {
+                checkpoint = 0;
+            }
+            if (checkpoint < 1 || checkpoint > 86400) {
+                std::cerr << "ERROR: invalid checkpoint interval: " << arg.substr(13) << ", expected 1 to 86400 seconds\n";
+                return 17;
+            }
+        } else if (arg == "--resume") {
+            resume = true;
+        } else if (arg.compare(0, 9, "--extend=") == 0) {
+            extend = arg.substr(9);
+        } else if (arg.compare(0, 8, "--cache=") == 0) {
+            cache = arg.substr(8);
+        } else if (arg.compare(0, 7, "--simd=") == 0) {
+            std::string simd_arg = arg.substr(7);
+
+            if (simd_arg == "scalar") {
+                simd = SimdLevel::scalar;
+            } else if (simd_arg == "sse41") {
+                simd = SimdLevel::sse41;
+            } else if (simd_arg == "avx2") {
+                simd = SimdLevel::avx2;
+            } else if (simd_arg == "avx512") {
+                simd = SimdLevel::avx512;
+            } else {
+                std::cerr << "ERROR: unknown simd level: " << simd_arg << ", expected scalar, sse41, avx2 or avx512\n";
+                return 16;
+            }
+        } else {
+            args.push_back(argv[a]);
+        }
+    }
+
+    argc = static_cast<int>(args.size());
+    argv = args.data();
 
     if (argc > 1 && (std::string(argv[1]) == "-h" || std::string(argv[1]) == "--help" || std::string(argv[1]) == "help")) {
         std::string name{argv[0]};
         std::cout << "usage:\n\t" << name << " " << p_def << " " << r_def << " " << t_def << '\n'
-                  << "\t" << name << " p r t\n"
+                  << "\t" << name << " p r t [--engine=brute|pairs|heap|window] [--consumers=c] [--simd=scalar|sse41|avx2|avx512] [--binary] [--checkpoint=s] [--resume] [--extend=file] [--cache=dir]\n"
                   << "\tp: gives the range for taxicab numbers [1, 10^p]\n"
                   << "\tr: gives the range for cubes [1, 10^r]\n"
                   << "\tt: gives the number of producer threads\n"
+                  << "\t--engine=brute: tries all cube pairs for every number of the range\n"
+                  << "\t--engine=pairs: enumerates the sums of cube pairs up to 10^p directly\n"
+                  << "\t--engine=heap: enumerates the sums in increasing order, keeps only taxicab candidates\n"
+                  << "\t--engine=window: counts the sums of a cache-sized window at a time, keeps only taxicab candidates\n"
+                  << "\t--consumers=c: saves the sums on c consumer threads, each owns the numbers of its shard\n"
+                  << "\t--simd=level: the brute engine's kernel, by default the widest of this CPU: " << simd_name(simd_detect()) << "\n"
+                  << "\t--binary: writes the memory-mappable binary format of taxicab_reader.h instead of json\n"
+                  << "\t--checkpoint=s: saves the state of the run every s seconds, Ctrl-C stops it with a last checkpoint\n"
+                  << "\t--resume: continues the run of the same p, r, t and engine from its checkpoint, by default with checkpoints every 600 s\n"
+                  << "\t--extend=file: keeps the results of a binary file of a smaller p or r and searches only what they miss\n"
+                  << "\t--cache=dir: answers from the results of an earlier run of at least p and r in dir, saves new results there\n"
                   << "version: " << APP_VERSION << '\n'
                   << "compiler: " << CXX_COMPILER << '\n'
                   << "standard: " << CXX_STANDARD << '\n'
@@ -57,7 +160,7 @@ int main(int argc, char **argv) {
         p = p_def;
     }
 
-    N = std::pow(10, p);
+    pow10_checked(p, N);
 
     if (argc > 2) {
         try {
@@ -109,18 +212,76 @@ int main(int argc, char **argv) {
     std::cout << std::setw(width) << std::right << "taxicab range N = " << N << '\n';
     std::cout << std::setw(width) << std::right << "integer cube range R = " << R << '\n';
     std::cout << std::setw(width) << std::right << "number of worker threads T = " << T << '\n';
+    std::cout << std::setw(width) << std::right << "search engine = " << engine_name << '\n';
+    std::cout << std::setw(width) << std::right << "number of consumer threads C = " << C << '\n';
 
     std::chrono::milliseconds timeout{10};
     std::chrono::milliseconds check{1};
 
-#ifdef SOLUTION_INT
+#if defined(SOLUTION_INT)
     TaxiCabNumberInt
+#elif defined(SOLUTION_PIPE)
+    TaxiCabNumberPipe
+#elif defined(SOLUTION_FLAT)
+    TaxiCabNumberFlat
 #else
     TaxiCabNumberStr
 #endif
     taxicab_number{N, R, T, timeout, check};
 
+    taxicab_number.search_engine(engine);
+    taxicab_number.consumer_threads(C);
+    taxicab_number.simd_level(simd);
+    taxicab_number.write_binary(binary);
+    taxicab_number.cache_dir(cache);
+    std::cout << std::setw(width) << std::right << "simd level = " << simd_name(taxicab_number.simd_level()) << '\n';
+
+    // before a resume, which checks the extended range
+    if (!extend.empty()) {
+        std::cout << std::setw(width) << std::right << "extended results = " << extend << '\n';
+
+        if (!taxicab_number.extend(extend)) {
+            std::cerr << "ERROR: cannot extend the results of " << extend << '\n';
+            return 20;
+        }
+    }
+
+    if (checkpoint > 0 || resume) {
+#ifdef SOLUTION_PIPE
+        std::cerr << "ERROR: the pipeline solution runs in one go, it has no checkpoints\n";
+        return 19;
+#else
+        taxicab_number.checkpoint_interval(std::chrono::seconds{checkpoint > 0 ? checkpoint : 600});
+        std::cout << std::setw(width) << std::right << "checkpoint file = " << taxicab_number.checkpoint_file() << '\n';
+
+        if (resume && !taxicab_number.resume()) {
+            std::cerr << "ERROR: no checkpoint to resume\n";
+            return 18;
+        }
+
+        running = &taxicab_number;
+        std::signal(SIGINT, stop_running);
+        std::signal(SIGTERM, stop_running);
+#endif
+    }
+
     taxicab_number.run();
 
+    if (taxicab_number.from_cache()) {
+        std::cout << "answered from the cache\n";
+    }
+
+    if (running != nullptr && taxicab_number.report_file().empty()) {
+        std::cout << "stopped, continue with --resume\n";
+    }
+
+#ifdef SOLUTION_PIPE
+    for (auto& stage : taxicab_number.stats()) {
+        std::cout << std::setw(width) << std::right << "stage " + stage.name + " = "
+                  << stage.items << " items, " << stage.threads << " threads, "
+                  << static_cast<uint64_t>(stage.throughput()) << " items/s\n";
+    }
+#endif
+
     return 0;
 }
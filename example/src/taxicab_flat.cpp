@@ -0,0 +1,67 @@
+#include <utility>
+#include <tuple>
+#include <algorithm>
+
+#include "../include/taxicab_number.h"
+
+void TaxiCabNumberFlat::save_taxicab_number(std::atomic<bool>& loop, std::size_t shard) {
+    CubeSum ta{};
+    auto& cube = _cube[shard];
+
+    // a popped element is saved even after the producers are done
+    while (next_sum(loop, shard, ta)) {
+        auto ab = std::minmax(std::get<1>(ta), std::get<2>(ta));
+        cube.insert(std::get<0>(ta), ab.first, ab.second);
+    }
+}
+
+void TaxiCabNumberFlat::resize_shards(std::size_t shards) {
+    _cube.resize(shards);
+}
+
+void TaxiCabNumberFlat::snapshot(const std::function<void(const CubeSum&)>& visit) {
+    for (auto& shard : _cube) {
+        shard.for_each([&visit](const CubeTable::Slot& slot) {
+            for (uint32_t p = 0; p < slot.count; ++p) {
+                visit(CubeSum{slot.key, slot.pairs[p].first, slot.pairs[p].second});
+            }
+        });
+    }
+}
+
+void TaxiCabNumberFlat::report_taxicab_number(const int rank) {
+    std::vector<const CubeTable::Slot*> slots{};
+    std::size_t size_cube = 0;
+
+    for (auto& shard : _cube) {
+        size_cube += shard.size();
+        shard.for_each([&slots, rank](const CubeTable::Slot& slot) {
+            if (slot.count >= static_cast<uint32_t>(rank)) {
+                slots.push_back(&slot);
+            }
+        });
+    }
+
+    // the table has no order, the few taxicab numbers are sorted once
+    std::sort(slots.begin(), slots.end(), [](const CubeTable::Slot* x, const CubeTable::Slot* y) {
+        return x->key < y->key;
+    });
+
+    _taxicab.clear();
+    for (auto slot : slots) {
+        TaxiCab found(slot->key);
+        found.cube.assign(slot->pairs, slot->pairs + slot->count);
+        // the order of arrival depends on the engine and the threads
+        std::sort(found.cube.begin(), found.cube.end());
+        _taxicab.push_back(found);
+    }
+
+    dump_taxicab_number(rank, size_all(size_cube), _taxicab.size());
+}
+
+void TaxiCabNumberFlat::clear() {
+    Base::clear();
+    for (auto& shard : _cube) {
+        shard.clear();
+    }
+}
@@ -9,34 +9,28 @@
 
 #include "../include/taxicab_number.h"
 
-void TaxiCabNumberStr::save_taxicab_number(bool& loop) {
-    std::tuple<uint32_t, uint32_t, uint32_t> ta{};
-
-    while (loop) {
-        bool go = _queue.wait_and_pop_while(ta, _timeout, _check);
-
-        if (!loop) {
-            break;
-        }
-
-        if (go) {
-            uint32_t i = std::get<0>(ta);
-            uint32_t j = std::get<1>(ta);
-            uint32_t k = std::get<2>(ta);
-
-            auto ab = std::minmax(j, k);
-            uint64_t a = ab.first;
-            uint64_t b = ab.second;
-
-            auto ta = std::to_string(a) + '.' + std::to_string(b);
-
-            auto it = _cube.find(i);
-            if (it == _cube.end()) { // first time
-                _cube.insert({i, ta});
-            } else {
-                if (it->second.find(ta) == std::string::npos) {  // not found before
-                    it->second += '.' + ta;
-                }
+void TaxiCabNumberStr::save_taxicab_number(std::atomic<bool>& loop, std::size_t shard) {
+    CubeSum ta{};
+    auto& cube = _cube[shard];
+
+    // a popped element is saved even after the producers are done
+    while (next_sum(loop, shard, ta)) {
+        uint64_t i = std::get<0>(ta);
+        uint32_t j = std::get<1>(ta);
+        uint32_t k = std::get<2>(ta);
+
+        auto ab = std::minmax(j, k);
+        uint64_t a = ab.first;
+        uint64_t b = ab.second;
+
+        auto ta = std::to_string(a) + '.' + std::to_string(b);
+
+        auto it = cube.find(i);
+        if (it == cube.end()) { // first time
+            cube.insert({i, ta});
+        } else {
+            if (it->second.find(ta) == std::string::npos) {  // not found before
+                it->second += '.' + ta;
             }
         }
     }
@@ -58,8 +52,8 @@ std::vector<std::string> TaxiCabNumberStr::split(const std::string& s, const cha
 
 void TaxiCabNumberStr::report_taxicab_number(const int rank) {
     _taxicab.clear();
-    for (auto it = _cube.cbegin(); it != _cube.cend(); ++it) {
-        std::pair<uint32_t, std::string> ra = *it;
+    // the shards hold disjoint numbers, merged they are in ascending order as one map
+    merge_shards(_cube, [this, rank](const std::pair<const uint64_t, std::string>& ra, std::size_t) {
         auto data = split(ra.second, '.');
 
         if (data.size() >= (2 * rank)) {
@@ -71,136 +65,103 @@ void TaxiCabNumberStr::report_taxicab_number(const int rank) {
                 found.cube.push_back({a, b});
             }
 
+            // the order of arrival depends on the engine and the threads
+            std::sort(found.cube.begin(), found.cube.end());
             _taxicab.push_back(found);
         }
+    });
+
+    dump_taxicab_number(rank, size_all(shards_size(_cube)), _taxicab.size());
+}
+
+void TaxiCabNumberStr::snapshot(const std::function<void(const CubeSum&)>& visit) {
+    for (auto& shard : _cube) {
+        for (auto& ra : shard) {
+            auto data = split(ra.second, '.');
+
+            for (std::size_t j = 0; j + 1 < data.size(); j += 2) {
+                visit(CubeSum{ra.first, static_cast<uint32_t>(std::stoul(data[j])), static_cast<uint32_t>(std::stoul(data[j + 1]))});
+            }
+        }
     }
+}
 
-    dump_taxicab_number(rank, _cube.size(), _taxicab.size());
+void TaxiCabNumberStr::resize_shards(std::size_t shards) {
+    _cube.resize(shards);
 }
 
 void TaxiCabNumberStr::clear() {
     Base::clear();
-    _cube.clear();
+    for (auto& shard : _cube) {
+        shard.clear();
+    }
 }
 
 // -----------------------------------------------------------------------------
 
-void TaxiCabNumberInt::save_taxicab_number(bool& loop) {
-     std::tuple<uint32_t, uint32_t, uint32_t> ta{};
+void TaxiCabNumberInt::save_taxicab_number(std::atomic<bool>& loop, std::size_t shard) {
+    CubeSum ta{};
+    auto& cube = _cube[shard];
+    auto& pairs = _pairs[shard];
 
-    while (loop) {
-        bool go = _queue.wait_and_pop_while(ta, _timeout, _check);
+    // a popped element is saved even after the producers are done
+    while (next_sum(loop, shard, ta)) {
+        uint64_t i = std::get<0>(ta);
+        uint32_t j = std::get<1>(ta);
+        uint32_t k = std::get<2>(ta);
 
-        if (!loop) {
-            break;
-        }
+        auto ab = std::minmax(j, k);
 
-        if (go) {
-            uint32_t i = std::get<0>(ta);
-            uint32_t j = std::get<1>(ta);
-            uint32_t k = std::get<2>(ta);
-
-            auto ab = std::minmax(j, k);
-            uint64_t a = ab.first;
-            uint64_t b = ab.second;
-
-            auto it = _cube.find(i);
-            if (it == _cube.end()) { // first time
-                uint64_t xa = a;
-                uint64_t xb = b << 10;
-                uint64_t xc = xa | xb;
-
-                _cube.insert({i, xc});
-            } else {
-#if __cplusplus > 201703L  // C++20
-                int pos = 64 - std::countl_zero(it->second);
-#else
-                int pos = 64 - __builtin_clzll(it->second);
-#endif
-                if (pos >= 0 && pos < 20) {
-                    uint64_t xnum1 = it->second & 1048575;              // ignore other entries: 0000000000000000000000000000000000000000000011111111111111111111
-                    uint64_t xa1 = a;
-                    uint64_t xb1 = b << 10;
-                    uint64_t xc1 = xa1 | xb1;
-
-                    if (xc1 != xnum1) {
-                        uint64_t xa = a << 20;
-                        uint64_t xb = b << 30;
-                        it->second |= xa | xb;
-                    }
-                } else if (pos >= 20 && pos < 40) {
-                    uint64_t xnum1 = it->second & 1048575;              // ignore other entries: 0000000000000000000000000000000000000000000011111111111111111111
-                    uint64_t xa1 = a;
-                    uint64_t xb1 = b << 10;
-                    uint64_t xc1 = xa1 | xb1;
-
-                    uint64_t xnum2 = it->second & 1099510579200;        // ignore other entries: 0000000000000000000000001111111111111111111100000000000000000000
-                    uint64_t xa2 = a << 20;
-                    uint64_t xb2 = b << 30;
-                    uint64_t xc2 = xa2 | xb2;
-
-                    if ((xc1 != xnum1) && (xc2 != xnum2)) {
-                        uint64_t xa = a << 40;
-                        uint64_t xb = b << 50;
-                        it->second |= xa | xb;
-                    }
-                }
-            }
+        auto it = cube.insert({i, pairs.pack(ab.first, ab.second)});
+        if (!it.second) { // not the first time
+            it.first->second = pairs.add(it.first->second, ab.first, ab.second);
         }
     }
 }
 
-std::vector<uint16_t> TaxiCabNumberInt::split(const uint64_t x) {
-    int size = 0;
-#if __cplusplus > 201703L  // C++20
-    int pos = 64 - std::countl_zero(x);
-#else
-    int pos = 64 - __builtin_clzll(x);
-#endif
-
-    if (pos >= 0 && pos < 20) {
-        size = 2;
-    } else if (pos >= 21 && pos < 40) {
-        size = 4;
-    } else {
-        size = 6;
-    }
-
-    std::vector<uint16_t> nums{};
-    nums.reserve(size);
-    uint64_t mask = 1023;   // 2^10 - 1;
-
-    for (int i = 0; i < size; ++i) {
-        uint64_t num = (x & (mask << (i * 10))) >> (i * 10);
-        nums.push_back(static_cast<uint16_t>(num));
-    }
-
-    return nums;
-}
-
 void TaxiCabNumberInt::report_taxicab_number(const int rank) {
     _taxicab.clear();
-    for (auto it = _cube.cbegin(); it != _cube.cend(); ++it) {
-        std::pair<uint32_t, uint64_t> ra = *it;
-        auto data = split(ra.second);
+    // the shards hold disjoint numbers, merged they are in ascending order as one map
+    merge_shards(_cube, [this, rank](const std::pair<const uint64_t, uint64_t>& ra, std::size_t shard) {
+        auto& pairs = _pairs[shard];
 
-        if (data.size() >= (2 * rank)) {
+        if (pairs.count(ra.second) >= static_cast<std::size_t>(rank)) {
             TaxiCab found(ra.first);
 
-            for (int j = 0; j < data.size(); j += 2) {
-                uint16_t a = data[j];
-                uint16_t b = data[j + 1];
-                found.cube.push_back({a, b});
-            }
+            pairs.for_each(ra.second, [&found](const CubePair& ab) {
+                found.cube.push_back(ab);
+            });
 
+            // the order of arrival depends on the engine and the threads
+            std::sort(found.cube.begin(), found.cube.end());
             _taxicab.push_back(found);
         }
+    });
+
+    dump_taxicab_number(rank, size_all(shards_size(_cube)), _taxicab.size());
+}
+
+void TaxiCabNumberInt::snapshot(const std::function<void(const CubeSum&)>& visit) {
+    for (std::size_t s = 0; s < _cube.size(); ++s) {
+        for (auto& ra : _cube[s]) {
+            _pairs[s].for_each(ra.second, [&visit, &ra](const CubePair& ab) {
+                visit(CubeSum{ra.first, ab.first, ab.second});
+            });
+        }
     }
+}
 
-    dump_taxicab_number(rank, _cube.size(), _taxicab.size());
+void TaxiCabNumberInt::resize_shards(std::size_t shards) {
+    _cube.resize(shards);
+    _pairs.resize(shards, PackedPairs{_R});
 }
 
 void TaxiCabNumberInt::clear() {
     Base::clear();
-    _cube.clear();
+    for (auto& shard : _cube) {
+        shard.clear();
+    }
+    for (auto& pairs : _pairs) {
+        pairs.clear();
+    }
 }
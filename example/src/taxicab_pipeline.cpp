@@ -0,0 +1,204 @@
+#include <utility>
+#include <tuple>
+#include <algorithm>
+
+#include "../include/taxicab_number.h"
+#include "../../include/reorder_buffer.h"
+
+void TaxiCabNumberPipe::aggregate(const CubeSum& ta, std::size_t shard) {
+    uint64_t i = std::get<0>(ta);
+    auto ab = std::minmax(std::get<1>(ta), std::get<2>(ta));
+    CubePair cube{ab.first, ab.second};
+
+    auto& cubes = _cube[shard][i];
+    if (std::find(cubes.cbegin(), cubes.cend(), cube) == cubes.cend()) {  // not found before
+        cubes.push_back(cube);
+    }
+}
+
+void TaxiCabNumberPipe::collect(const int rank) {
+    _taxicab.clear();
+    merge_shards(_cube, [this, rank](const std::pair<const uint64_t, std::vector<CubePair>>& cubes, std::size_t) {
+        if (cubes.second.size() >= static_cast<std::size_t>(rank)) {
+            TaxiCab found(cubes.first);
+            found.cube = cubes.second;
+            // the order of arrival depends on the engine and the threads
+            std::sort(found.cube.begin(), found.cube.end());
+            _taxicab.push_back(found);
+        }
+    });
+}
+
+// the consumer of Base::run(), run() below feeds aggregate() from its own stage
+void TaxiCabNumberPipe::save_taxicab_number(std::atomic<bool>& loop, std::size_t shard) {
+    CubeSum ta{};
+
+    // a popped element is saved even after the producers are done
+    while (next_sum(loop, shard, ta)) {
+        aggregate(ta, shard);
+    }
+}
+
+void TaxiCabNumberPipe::resize_shards(std::size_t shards) {
+    _cube.resize(shards);
+}
+
+void TaxiCabNumberPipe::report_taxicab_number(const int rank) {
+    collect(rank);
+    dump_taxicab_number(rank, size_all(shards_size(_cube)), _taxicab.size());
+}
+
+// the pipeline runs in one go, only Base::run() takes checkpoints
+void TaxiCabNumberPipe::snapshot(const std::function<void(const CubeSum&)>& visit) {
+    for (auto& shard : _cube) {
+        for (auto& cubes : shard) {
+            for (const CubePair& ab : cubes.second) {
+                visit(CubeSum{cubes.first, ab.first, ab.second});
+            }
+        }
+    }
+}
+
+void TaxiCabNumberPipe::run() {
+    // report taxicab numbers with at least this rank
+    const int rank = 2;
+    // the format threads wait here while their entry is too far ahead of the writer
+    ReorderBuffer<std::string> pending{FORMAT_WINDOW * _format_threads};
+    // the last aggregate thread to finish collects the shards
+    std::atomic<uint32_t> aggregating{_C};
+    // the write stage is the only reader of these
+    uint64_t next = 0;
+    ReportWriter out;
+    bool begun = false;
+    bool writing = false;
+
+    Pipeline pipeline;
+
+    if (answer_from_cache()) {
+        return;
+    }
+
+    _t_start = std::chrono::steady_clock::now();
+    resize_shards(_C);
+
+    // the numbers of an extended run's earlier results
+    for (const CubeSum& ta : _resumed) {
+        aggregate(ta, std::get<0>(ta) % _C);
+    }
+    _resumed.clear();
+
+    // one or more search threads pull chunks as in Base::run()
+    start_chunks();
+    auto& sums = pipeline.source<CubeSum, RingQueue>("search", _T,
+        [this](std::size_t, PipelineEmitter<CubeSum>& emit) {
+            produce_chunks([&emit](const CubeSum& ta) { emit(ta); });
+        });
+    // all sums of a number reach the same aggregate thread
+    sums.key_by([this](const CubeSum& ta) { return static_cast<std::size_t>(std::get<0>(ta) % _C); });
+
+    // each aggregate thread owns a shard of _cube, the taxicab numbers leave the merge in ascending order
+    auto& found = pipeline.transform<CubeSum, Found>("aggregate", _C, sums,
+        [this](const CubeSum& ta, PipelineEmitter<Found>&) {
+            aggregate(ta, std::get<0>(ta) % _C);
+        },
+        [this, rank, &aggregating](std::size_t, PipelineEmitter<Found>& emit) {
+            if (--aggregating > 0) {
+                return;
+            }
+
+            _t_end = std::chrono::steady_clock::now();
+            collect(rank);
+
+            for (std::size_t i = 0; i < _taxicab.size(); ++i) {
+                emit(Found{i, &_taxicab[i]});
+            }
+        });
+
+    // an entry goes to the window, the writer is told its sequence number
+    auto& entries = pipeline.transform<Found, uint64_t>("format", _format_threads, found,
+        [this, &pending](const Found& tc, PipelineEmitter<uint64_t>& emit) {
+            // the binary file is written from _taxicab as a whole
+            if (_binary) {
+                return;
+            }
+
+            // without a file the writer keeps the text
+            ReportWriter entry;
+
+            if (_json) {
+                _util.write_json_taxicab(entry, *tc.second);
+            } else {
+                _util.write_txt_taxicab(entry, tc.first + 1, *tc.second);
+            }
+
+            // waits while tc.first is a window or more ahead of the writer
+            pending.push(tc.first, entry.str());
+            emit(tc.first);
+        });
+
+    // parallel formatters finish out of order, entries are written in sequence by one thread to one file,
+    // an entry is in the window before its number reaches this stage, so the last number finds all of them
+    // the file is opened with the first entry, the totals are known by then
+    pipeline.sink<uint64_t>("write", 1, entries,
+        [this, rank, &pending, &next, &out, &begun, &writing](const uint64_t&) {
+            if (!begun) {
+                begun = true;
+                writing = _util.begin_report(out, rank, size_all(shards_size(_cube)), _taxicab.size());
+            }
+
+            // without a file the entries are only taken out of the window
+            std::string text{};
+            while (pending.try_pop(text)) {
+                if (!writing) {
+                    continue;
+                }
+                if (_json && next > 0) {
+                    out.put(",\n");
+                }
+                out.put(text);
+                ++next;
+            }
+        },
+        [this, rank, &next, &out, &begun, &writing](std::size_t) {
+            if (_binary) {
+                _util.dump_binary_taxicab_number(rank, size_all(shards_size(_cube)), _taxicab.size());
+                save_to_cache(rank, size_all(shards_size(_cube)), _taxicab.size());
+                return;
+            }
+
+            if (!begun) {
+                writing = _util.begin_report(out, rank, size_all(shards_size(_cube)), _taxicab.size());
+            }
+            if (!writing) {
+                return;
+            }
+
+            _util.end_report(out, next == 0);
+            save_to_cache(rank, size_all(shards_size(_cube)), _taxicab.size());
+        });
+
+    pipeline.run();
+
+    _stats = pipeline.stats();
+}
+
+// the consumer threads of Base::run()
+void TaxiCabNumberPipe::aggregate_threads(uint32_t threads) {
+    consumer_threads(threads);
+}
+
+void TaxiCabNumberPipe::format_threads(uint32_t threads) {
+    _format_threads = threads > 0 ? threads : 1;
+}
+
+std::vector<PipelineStats>& TaxiCabNumberPipe::stats() {
+    return _stats;
+}
+
+void TaxiCabNumberPipe::clear() {
+    Base::clear();
+    for (auto& shard : _cube) {
+        shard.clear();
+    }
+    _stats.clear();
+}
@@ -1,5 +1,26 @@
 #include "../include/taxicab_number.h"
 #include "../include/utility.h"
+#include "../include/taxicab_reader.h"
+#include "../include/taxicab_checkpoint.h"
+
+#include <sys/stat.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// a rename is durable once the directory's entry is on disk too
+static bool sync_dir(const std::string& dir_name) {
+    int fd = ::open(dir_name.c_str(), O_RDONLY | O_DIRECTORY);
+
+    if (fd < 0) {
+        return false;
+    }
+
+    bool synced = ::fsync(fd) == 0;
+    ::close(fd);
+
+    return synced;
+}
 
 // by Howard Hinnant, modified for ms & C++11
 // https://stackoverflow.com/questions/60046147/how-to-convert-chronoseconds-to-string-in-hhmmss-format-in-c
@@ -61,107 +82,479 @@ std::string Utility::gen_file_name() {
     std::tm tm = *std::localtime(&t);
     dump << std::put_time(&tm, "%Y-%m-%d_%H-%M-%S");
 
-    return _base->_prefix + dump.str() + (_base->_json ? ".json" : ".txt");
+    return _base->_prefix + dump.str() + (_base->_binary ? ".bin" : (_base->_json ? ".json" : ".txt"));
 }
 
-void Utility::report_header(std::ostringstream& dump, const uint32_t rank, const std::size_t size_all, const std::size_t size_tc) {
-    const int width = 36;
-    dump << std::setw(width) << std::right << "taxicab range N = " << _base->_N << '\n'
-         << std::setw(width) << std::right << "integer cube range R = " << _base->_R << '\n'
-         << std::setw(width) << std::right << "number of worker threads T = " << _base->_T << '\n'
-         << "\nall numbers with cubes [1, " << _base->_N << "]: " << size_all  << '\n'
-         << "Taxicab(" << rank << ") or more in range [1, " << _base->_N << "]: " << size_tc << '\n';
+void Utility::report_header(ReportWriter& out, const uint32_t rank, const std::size_t size_all, const std::size_t size_tc) {
+    const std::size_t width = 36;
+    out.put_right("taxicab range N = ", width).put_uint(_base->_N).put('\n')
+       .put_right("integer cube range R = ", width).put_uint(_base->_R).put('\n')
+       .put_right("number of worker threads T = ", width).put_uint(_base->_T).put('\n')
+       .put("\nall numbers with cubes [1, ").put_uint(_base->_N).put("]: ").put_uint(size_all).put('\n')
+       .put("Taxicab(").put_uint(rank).put(") or more in range [1, ").put_uint(_base->_N).put("]: ").put_uint(size_tc).put('\n');
 }
 
-void Utility::report_footer(std::ostringstream& dump) {
-    dump << "elapsed time: " << elapsed_time(std::chrono::duration_cast<std::chrono::milliseconds>(_base->_t_end - _base->_t_start)) << '\n';
+void Utility::report_footer(ReportWriter& out) {
+    out.put("elapsed time: ").put(elapsed_time(std::chrono::duration_cast<std::chrono::milliseconds>(_base->_t_end - _base->_t_start))).put('\n');
 }
 
-void Utility::report_meta(std::ostringstream& dump, const uint32_t rank, const std::size_t size_all, const std::size_t size_tc) {
-    dump << "{\"meta\":{\"n\":" << _base->_N
-         << ",\"r\":" << _base->_R
-         << ",\"t\":" << _base->_T
-         << ",\"total_cubes\":" << size_all
-         << ",\"total_taxicabs\":" << size_tc
-         << ",\"elapsed_time\":\"" << elapsed_time(std::chrono::duration_cast<std::chrono::milliseconds>(_base->_t_end - _base->_t_start)) << "\"},\n";
+void Utility::report_meta(ReportWriter& out, const uint32_t rank, const std::size_t size_all, const std::size_t size_tc) {
+    out.put("{\"meta\":{\"n\":").put_uint(_base->_N)
+       .put(",\"r\":").put_uint(_base->_R)
+       .put(",\"t\":").put_uint(_base->_T)
+       .put(",\"total_cubes\":").put_uint(size_all)
+       .put(",\"total_taxicabs\":").put_uint(size_tc)
+       .put(",\"elapsed_time\":\"").put(elapsed_time(std::chrono::duration_cast<std::chrono::milliseconds>(_base->_t_end - _base->_t_start))).put("\"},\n");
 }
 
-void Utility::dump_txt_taxicab_number(const int rank, const std::size_t size_all, const std::size_t size_tc) {
-    std::ostringstream dump;
-    report_header(dump, rank, size_all, size_tc);
+// one line of the txt list, index counts from 1
+void Utility::write_txt_taxicab(ReportWriter& out, const std::size_t index, const TaxiCab& tc) {
+    out.put_uint(index, 5).put(".\t").put_uint(tc.taxicab_no, 10);
 
-    int i = 0;
-    for (TaxiCab tc : _base->_taxicab) {
-        dump << std::setw(5) << ++i << '.' << '\t'
-             << std::setw(10) << static_cast<int64_t>(tc.taxicab_no);
+    for (const CubePair& ab : tc.cube) {
+        out.put(" = ").put_uint(ab.first, 3).put("^3 + ").put_uint(ab.second, 3).put("^3");
+    }
 
-        for (int j = 0; j < tc.cube.size(); j += 2) {
-            dump << " = "
-                 << std::setw(3) << tc.cube[j].first << "^3 + "
-                 << std::setw(3) << tc.cube[j].second << "^3";
+    out.put('\n');
+}
+
+// one element of the json list, without a separator
+void Utility::write_json_taxicab(ReportWriter& out, const TaxiCab& tc) {
+    out.put("{\"taxicab\":").put_uint(tc.taxicab_no).put(",\"cubes\":[");
+
+    for (std::size_t j = 0; j < tc.cube.size(); ++j) {
+        if (j > 0) {
+            out.put(',');
         }
+        out.put('[').put_uint(tc.cube[j].first).put(", ").put_uint(tc.cube[j].second).put(']');
+    }
+
+    out.put("]}");
+}
+
+void Utility::dump_txt_taxicab_number(const int rank, const std::size_t size_all, const std::size_t size_tc) {
+    ReportWriter out;
+
+    if (!begin_report(out, rank, size_all, size_tc)) {
+        return;
+    }
 
-        dump << '\n';
+    std::size_t i = 0;
+    for (const TaxiCab& tc : _base->_taxicab) {
+        write_txt_taxicab(out, ++i, tc);
     }
-    dump << '\n';
 
-    report_footer(dump);
-    save_report(dump);
+    end_report(out, _base->_taxicab.empty());
 }
 
 void Utility::dump_json_taxicab_number(const int rank, const std::size_t size_all, const std::size_t size_tc) {
-    std::ostringstream dump;
-    report_meta(dump, rank, size_all, size_tc);
+    ReportWriter out;
 
-    dump << "\"list\":[\n";
-    if (_base->_taxicab.size() > 0) {
-        for (TaxiCab tc : _base->_taxicab) {
-            dump << "{\"taxicab\":" << static_cast<int64_t>(tc.taxicab_no) << ",\"cubes\":[";
+    if (!begin_report(out, rank, size_all, size_tc)) {
+        return;
+    }
 
-            for (int j = 0; j < tc.cube.size(); ++j) {
-                dump << "[" << tc.cube[j].first << ", "
-                     << tc.cube[j].second << "],";
-            }
-            dump.seekp(-1, std::ios_base::end);
-            dump << "]},\n";
+    bool first = true;
+    for (const TaxiCab& tc : _base->_taxicab) {
+        if (!first) {
+            out.put(",\n");
+        }
+        write_json_taxicab(out, tc);
+        first = false;
+    }
+
+    end_report(out, _base->_taxicab.empty());
+}
+
+// opens the report file and writes everything before the list
+bool Utility::begin_report(ReportWriter& out, const int rank, const std::size_t size_all, const std::size_t size_tc) {
+    if (!open_report(out)) {
+        return false;
+    }
+
+    if (_base->_json) {
+        report_meta(out, rank, size_all, size_tc);
+        out.put("\"list\":[\n");
+    } else {
+        report_header(out, rank, size_all, size_tc);
+    }
+
+    return true;
+}
+
+// writes everything after the list and closes the report file
+bool Utility::end_report(ReportWriter& out, const bool empty) {
+    if (_base->_json) {
+        if (!empty) {
+            out.put('\n');
         }
-        dump.seekp(-2, std::ios_base::end);
-        dump << '\n';
+        out.put("]}\n");
+    } else {
+        out.put('\n');
+        report_footer(out);
+    }
+
+    return close_report(out);
+}
+
+// the header and the three arrays of taxicab_reader.h in one sequential pass
+void Utility::dump_binary_taxicab_number(const int rank, const std::size_t size_all, const std::size_t size_tc) {
+    ReportWriter out;
+
+    if (!open_report(out)) {
+        return;
     }
-    dump << "]}\n";
 
-    save_report(dump);
+    write_binary(out, rank, size_all, size_tc);
+    close_report(out);
 }
 
-void Utility::save_report(std::ostringstream& dump) {
+void Utility::write_binary(ReportWriter& out, const int rank, const std::size_t size_all, const std::size_t size_tc) {
+    const std::vector<TaxiCab>& taxicab = _base->_taxicab;
+    TaxiCabFileHeader header{};
+    uint64_t total_pairs = 0;
+
+    for (const TaxiCab& tc : taxicab) {
+        total_pairs += tc.cube.size();
+    }
+
+    std::memcpy(header.magic, TAXICAB_FILE_MAGIC, sizeof(header.magic));
+    header.version = TAXICAB_FILE_VERSION;
+    header.rank = rank;
+    header.n = _base->_N;
+    header.r = _base->_R;
+    header.t = _base->_T;
+    header.total_cubes = size_all;
+    header.total_taxicabs = size_tc;
+    header.total_pairs = total_pairs;
+    header.elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(_base->_t_end - _base->_t_start).count();
+
+    out.put(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (const TaxiCab& tc : taxicab) {
+        uint64_t sum = tc.taxicab_no;
+        out.put(reinterpret_cast<const char*>(&sum), sizeof(sum));
+    }
+
+    uint64_t offset = 0;
+    out.put(reinterpret_cast<const char*>(&offset), sizeof(offset));
+    for (const TaxiCab& tc : taxicab) {
+        offset += tc.cube.size();
+        out.put(reinterpret_cast<const char*>(&offset), sizeof(offset));
+    }
+
+    for (const TaxiCab& tc : taxicab) {
+        for (const CubePair& ab : tc.cube) {
+            uint32_t pair[2] = {ab.first, ab.second};
+            out.put(reinterpret_cast<const char*>(pair), sizeof(pair));
+        }
+    }
+}
+
+bool Utility::open_report(ReportWriter& out) {
     std::string file_name = gen_file_name();
+    _base->_report_file = _base->_output_dir + "/" + file_name;
 
     if (_base->_display) {
-        std::cout << _base->_output_dir + "/" + file_name << '\n';
+        std::cout << _base->_report_file << '\n';
+    }
+
+    if (!out.open(_base->_report_file)) {
+        std::cerr << "error while opening file '" << file_name << "' | err: " << std::strerror(errno) << '\n';
+        return false;
+    }
+
+    return true;
+}
+
+bool Utility::close_report(ReportWriter& out) {
+    if (!out.close()) {
+        std::cerr << "error while writing to file '" << _base->_report_file << "' | err: " << std::strerror(errno) << '\n';
+        return false;
+    }
+
+    return true;
+}
+
+// the cursor and the sums of all shards, through a temporary file renamed over the last checkpoint
+bool Utility::save_checkpoint() {
+    TaxiCabCheckpointHeader header{};
+
+    std::memcpy(header.magic, TAXICAB_CHECKPOINT_MAGIC, sizeof(header.magic));
+    header.version = TAXICAB_CHECKPOINT_VERSION;
+    header.engine = static_cast<uint32_t>(_base->_engine);
+    header.n = _base->_N;
+    header.n_low = _base->_N_low;
+    header.r = _base->_R;
+    header.t = _base->_T;
+    header.next = _base->_chunks.position();
+    header.sum_count = _base->_sum_count.load();
+    header.elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(_base->_t_end - _base->_t_start).count();
+
+    std::string file_name = _base->checkpoint_file();
+    std::string temp_name = file_name + ".tmp";
+    ReportWriter out;
+
+    if (!out.open(temp_name)) {
+        std::cerr << "error while opening file '" << temp_name << "' | err: " << std::strerror(errno) << '\n';
+        return false;
+    }
+
+    out.put(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    uint64_t total_records = 0;
+    _base->snapshot([&out, &total_records](const CubeSum& ta) {
+        TaxiCabCheckpointRecord record{std::get<0>(ta), std::get<1>(ta), std::get<2>(ta)};
+        out.put(reinterpret_cast<const char*>(&record), sizeof(record));
+        ++total_records;
+    });
+
+    out.put(reinterpret_cast<const char*>(&total_records), sizeof(total_records));
+
+    if (!out.sync() || !out.close() || std::rename(temp_name.c_str(), file_name.c_str()) != 0) {
+        std::cerr << "error while writing to file '" << file_name << "' | err: " << std::strerror(errno) << '\n';
+        std::remove(temp_name.c_str());
+        return false;
     }
 
-    save_to_txt_file(file_name, dump.str());
+    if (!sync_dir(_base->_output_dir)) {
+        std::cerr << "error while syncing directory '" << _base->_output_dir << "' | err: " << std::strerror(errno) << '\n';
+        return false;
+    }
+
+    return true;
 }
 
-bool Utility::save_to_txt_file(const std::string& file_name, const std::string& content) {
-    std::ofstream out_file;
-    out_file.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+// a checkpoint of another N, R, T or engine is refused, an extended run is extended again before
+bool Utility::load_checkpoint() {
+    std::string file_name = _base->checkpoint_file();
+    std::ifstream in_file{file_name, std::ios::in | std::ios::binary};
+
+    if (!in_file.is_open()) {
+        std::cerr << "error while opening file '" << file_name << "'\n";
+        return false;
+    }
 
-    try {
-        out_file.open(_base->_output_dir + "/" + file_name, std::ios::out | std::ios::trunc);
+    TaxiCabCheckpointHeader header{};
+    in_file.seekg(0, std::ios::end);
+    uint64_t size = static_cast<uint64_t>(in_file.tellg());
+    in_file.seekg(0, std::ios::beg);
+
+    if (size < sizeof(header) + sizeof(uint64_t)
+        || (size - sizeof(header) - sizeof(uint64_t)) % sizeof(TaxiCabCheckpointRecord) != 0
+        || !in_file.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.magic, TAXICAB_CHECKPOINT_MAGIC, sizeof(header.magic)) != 0
+        || header.version != TAXICAB_CHECKPOINT_VERSION) {
+        std::cerr << "not a checkpoint file: '" << file_name << "'\n";
+        return false;
+    }
 
-        if (!out_file.is_open()) {
-            std::cerr << "error while opening file '" << file_name << "'\n";
-            return false;
+    if (header.engine != static_cast<uint32_t>(_base->_engine) || header.n != _base->_N || header.n_low != _base->_N_low || header.r != _base->_R || header.t != _base->_T) {
+        std::cerr << "checkpoint of another run: '" << file_name << "' | N = " << header.n << ", R = " << header.r
+                  << ", T = " << header.t << ", engine = " << header.engine << '\n';
+        return false;
+    }
+
+    uint64_t total_records = (size - sizeof(header) - sizeof(uint64_t)) / sizeof(TaxiCabCheckpointRecord);
+    std::vector<TaxiCabCheckpointRecord> records(std::min<uint64_t>(total_records, 1 << 16));
+    std::vector<CubeSum> resumed{};
+    resumed.reserve(total_records);
+
+    for (uint64_t left = total_records; left > 0; ) {
+        std::size_t n = static_cast<std::size_t>(std::min<uint64_t>(left, records.size()));
+
+        if (!in_file.read(reinterpret_cast<char*>(records.data()), n * sizeof(TaxiCabCheckpointRecord))) {
+            break;
+        }
+
+        for (std::size_t k = 0; k < n; ++k) {
+            resumed.push_back(CubeSum{records[k].i, records[k].a, records[k].b});
+        }
+
+        left -= n;
+    }
+
+    uint64_t trailer = 0;
+    if (resumed.size() != total_records || !in_file.read(reinterpret_cast<char*>(&trailer), sizeof(trailer)) || trailer != total_records) {
+        std::cerr << "truncated checkpoint file: '" << file_name << "'\n";
+        return false;
+    }
+
+    _base->_resumed.swap(resumed);
+    _base->_resumed_next = header.next;
+    _base->_resumed_elapsed = std::chrono::milliseconds{header.elapsed_ms};
+    _base->_sum_count = header.sum_count;
+
+    return true;
+}
+
+// the taxicab numbers of a binary result file and the sums of the grown cube range go to _resumed,
+// the consumers save them before the search of the new range
+bool Utility::load_results(const std::string& file_name) {
+    TaxiCabReader reader{};
+
+    if (!reader.open(file_name)) {
+        std::cerr << "not a taxicab result file: '" << file_name << "'\n";
+        return false;
+    }
+
+    const TaxiCabFileHeader& header = reader.header();
+
+    if (header.rank != 2 || header.n > _base->_N || header.r > _base->_R) {
+        std::cerr << "result file of a larger run: '" << file_name << "' | N = " << header.n << ", R = " << header.r << '\n';
+        return false;
+    }
+
+    std::vector<CubeSum> resumed{};
+    resumed.reserve(header.total_pairs);
+
+    for (std::size_t i = 0; i < reader.size(); ++i) {
+        TaxiCabReader::Entry entry = reader.at(i);
+
+        for (std::size_t p = 0; p < entry.count; ++p) {
+            resumed.push_back(CubeSum{entry.sum, entry.pairs[2 * p], entry.pairs[2 * p + 1]});
+        }
+    }
+
+    uint64_t fresh = Base::search_taxicab_grown(header.n, static_cast<uint32_t>(header.r), _base->_R, [&resumed](const CubeSum& ta) {
+        resumed.push_back(ta);
+    });
+
+    // the distinct numbers the consumers store again
+    std::vector<uint64_t> sums{};
+    sums.reserve(resumed.size());
+    for (const CubeSum& ta : resumed) {
+        sums.push_back(std::get<0>(ta));
+    }
+    std::sort(sums.begin(), sums.end());
+
+    _base->_resumed.swap(resumed);
+    _base->_N_low = header.n;
+    _base->_extend_cubes = header.total_cubes + fresh;
+    _base->_extend_stored = static_cast<std::size_t>(std::unique(sums.begin(), sums.end()) - sums.begin());
+
+    return true;
+}
+
+// taxicab_<N>_<R>_v<version>.bin
+std::string Utility::cache_file_name(const uint64_t n, const uint64_t r) {
+    return "taxicab_" + std::to_string(n) + '_' + std::to_string(r) + "_v" + std::to_string(TAXICAB_CACHE_VERSION) + ".bin";
+}
+
+// the sums up to n_max of the pairs a <= b < n_range, counted by a cube root per a
+uint64_t Utility::count_pairs(const uint64_t n_max, const uint64_t n_range) {
+    uint64_t count = 0;
+
+    for (uint64_t a = 1; a < n_range && 2 * a * a * a <= n_max; ++a) {
+        uint64_t b_max = std::min(n_range - 1, cube_root(n_max - a * a * a));
+        count += b_max - a + 1;
+    }
+
+    return count;
+}
+
+// the smallest cached run of this version that holds every pair of this run: N_c >= N and R_c >= R,
+// or R_c above every cube up to N; its taxicab numbers are filtered to N and R into _taxicab
+bool Utility::load_cache(std::size_t& size_all) {
+    const uint64_t N = _base->_N;
+    const uint64_t R = _base->_R;
+    DIR* dir = ::opendir(_base->_cache_dir.c_str());
+
+    if (dir == nullptr) {
+        return false;
+    }
+
+    // (n, r, name) of the files that cover the run
+    std::vector<std::tuple<uint64_t, uint64_t, std::string>> covering{};
+
+    for (struct dirent* entry = ::readdir(dir); entry != nullptr; entry = ::readdir(dir)) {
+        unsigned long long n = 0;
+        unsigned long long r = 0;
+        std::string name{entry->d_name};
+
+        if (std::sscanf(name.c_str(), "taxicab_%llu_%llu_v", &n, &r) != 2 || name != cache_file_name(n, r)) {
+            continue;
         }
 
-        out_file << content;
-        out_file.close();
+        uint64_t r3 = 0;
+        if (n >= N && (r >= R || !cube_checked(r, r3) || r3 >= N)) {
+            covering.emplace_back(n, r, name);
+        }
+    }
+
+    ::closedir(dir);
 
-        return true;
-    } catch (const std::ofstream::failure& e) {
-        std::cerr << "exception while writing to file '" << file_name << "' | err: " << e.what() << '\n';
+    // the smallest file first, a file that does not open or does not match is skipped
+    std::sort(covering.begin(), covering.end());
+    TaxiCabReader reader{};
+    bool loaded = false;
+
+    for (auto& file : covering) {
+        if (reader.open(_base->_cache_dir + "/" + std::get<2>(file))) {
+            if (reader.header().n == std::get<0>(file) && reader.header().r == std::get<1>(file) && reader.header().rank == 2) {
+                loaded = true;
+                break;
+            }
+        }
+    }
+
+    if (!loaded) {
         return false;
     }
+
+    // every number of two or more pairs is in the file, the others count once
+    uint64_t repeated = 0;
+    _base->_taxicab.clear();
+
+    for (std::size_t i = 0; i < reader.size() && reader.at(i).sum <= N; ++i) {
+        TaxiCabReader::Entry entry = reader.at(i);
+        TaxiCab found(entry.sum);
+
+        for (std::size_t p = 0; p < entry.count; ++p) {
+            if (entry.pairs[2 * p + 1] < R) {
+                found.cube.push_back(CubePair{entry.pairs[2 * p], entry.pairs[2 * p + 1]});
+            }
+        }
+
+        if (found.cube.size() >= 2) {
+            repeated += found.cube.size() - 1;
+            _base->_taxicab.push_back(found);
+        }
+    }
+
+    size_all = static_cast<std::size_t>(count_pairs(N, R) - repeated);
+
+    return true;
 }
 
+// the results of a finished run, through a temporary file renamed into the cache
+bool Utility::save_cache(const int rank, const std::size_t size_all, const std::size_t size_tc) {
+    if (::mkdir(_base->_cache_dir.c_str(), 0755) != 0 && errno != EEXIST) {
+        std::cerr << "error while creating directory '" << _base->_cache_dir << "' | err: " << std::strerror(errno) << '\n';
+        return false;
+    }
+
+    std::string file_name = _base->_cache_dir + "/" + cache_file_name(_base->_N, _base->_R);
+    std::string temp_name = file_name + ".tmp";
+    ReportWriter out;
+
+    if (!out.open(temp_name)) {
+        std::cerr << "error while opening file '" << temp_name << "' | err: " << std::strerror(errno) << '\n';
+        return false;
+    }
+
+    write_binary(out, rank, size_all, size_tc);
+
+    if (!out.sync() || !out.close() || std::rename(temp_name.c_str(), file_name.c_str()) != 0) {
+        std::cerr << "error while writing to file '" << file_name << "' | err: " << std::strerror(errno) << '\n';
+        std::remove(temp_name.c_str());
+        return false;
+    }
+
+    if (!sync_dir(_base->_cache_dir)) {
+        std::cerr << "error while syncing directory '" << _base->_cache_dir << "' | err: " << std::strerror(errno) << '\n';
+        return false;
+    }
+
+    return true;
+}
@@ -7,10 +7,20 @@
 #include "../../include/utility.h"
 #include "test_util.h"
 
+// two runs found the same taxicab numbers with the same cubes, in the same order
+inline void expect_same_taxicabs(const std::vector<TaxiCab>& found, const std::vector<TaxiCab>& expected) {
+    ASSERT_EQ(found.size(), expected.size());
+
+    for (std::size_t i = 0; i < found.size(); ++i) {
+        ASSERT_EQ(found[i].taxicab_no, expected[i].taxicab_no);
+        ASSERT_EQ(found[i].cube, expected[i].cube);
+    }
+}
+
 template<typename U>
 class CommonTests {
     public:
-        CommonTests(std::string name) : _name{name} {};
+        CommonTests(std::string name, Engine engine=Engine::brute, uint32_t consumers=1) : _name{name}, _engine{engine}, _consumers{consumers} {};
         CommonTests() = delete;
 
         // too small, no taxicab numbers
@@ -21,6 +31,8 @@ class CommonTests {
             std::cout << "test " << _name << " with n = 10^" << n << ", r = 10^" << r << ", t = " << t << '\n';
 
             U taxicab{N, R, t, _timeout, _check};
+            taxicab.search_engine(_engine);
+            taxicab.consumer_threads(_consumers);
 
             taxicab.run();
             std::this_thread::sleep_for(_delay);
@@ -38,6 +50,8 @@ class CommonTests {
             std::cout << "test " << _name << " with n = 10^" << n << ", r = 10^" << r << ", t = " << t << '\n';
 
             U taxicab{N, R, t, _timeout, _check};
+            taxicab.search_engine(_engine);
+            taxicab.consumer_threads(_consumers);
 
             taxicab.run();
             std::this_thread::sleep_for(_delay);
@@ -52,6 +66,8 @@ class CommonTests {
 
     private:
         std::string _name;
+        Engine _engine;
+        uint32_t _consumers;
         std::chrono::seconds _delay{1};
         std::chrono::milliseconds _timeout{10};
         std::chrono::milliseconds _check{1};
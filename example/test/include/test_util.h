@@ -3,9 +3,9 @@
 
 #include "../../include/taxicab_number.h"
 
-extern std::map<uint32_t, std::vector<std::pair<uint16_t, uint16_t>>> ref_taxicab;
+extern std::map<uint64_t, std::vector<CubePair>> ref_taxicab;
 
-int taxicab_count(uint32_t max);
+int taxicab_count(uint64_t max);
 bool check_taxicab(std::vector<TaxiCab>& calc_taxicab);
 
 #endif
@@ -7,7 +7,7 @@
 #include <cstdint>
 
 // https://www.numbersaplenty.com/set/taxicab_number/more.php
-std::map<uint32_t, std::vector<std::pair<uint16_t, uint16_t>>> ref_taxicab = {{1729, {{1, 12}, {9, 10}}},                       // 1
+std::map<uint64_t, std::vector<std::pair<uint32_t, uint32_t>>> ref_taxicab = {{1729, {{1, 12}, {9, 10}}},                       // 1
                                                                               {4104, {{2, 16}, {9, 15}}},                       // 2
                                                                               {13832, {{2, 24}, {18, 20}}},                     // 3
                                                                               {20683, {{10, 27}, {19, 24}}},                    // 4
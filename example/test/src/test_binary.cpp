@@ -0,0 +1,142 @@
+#include "gtest/gtest.h"
+#include <fstream>
+#include "../../include/taxicab_number.h"
+#include "../../include/taxicab_reader.h"
+#include "../include/test_common.h"
+
+// the mapped file against the numbers in memory
+template<typename U>
+void check_binary(U& taxicab, const uint64_t N, const uint32_t R) {
+    TaxiCabReader reader{};
+    ASSERT_TRUE(reader.open(taxicab.report_file())) << taxicab.report_file();
+
+    auto& found = taxicab.found();
+    const TaxiCabFileHeader& header = reader.header();
+
+    ASSERT_EQ(header.n, N);
+    ASSERT_EQ(header.r, R);
+    ASSERT_EQ(header.rank, 2u);
+    ASSERT_EQ(reader.size(), found.size());
+    ASSERT_EQ(reader.size(), taxicab_count(N));
+
+    for (std::size_t i = 0; i < found.size(); ++i) {
+        auto entry = reader.at(i);
+        ASSERT_EQ(entry.sum, found[i].taxicab_no);
+        ASSERT_EQ(entry.count, found[i].cube.size());
+
+        for (std::size_t p = 0; p < entry.count; ++p) {
+            ASSERT_EQ(entry.pairs[2 * p], found[i].cube[p].first);
+            ASSERT_EQ(entry.pairs[2 * p + 1], found[i].cube[p].second);
+        }
+
+        ASSERT_EQ(reader.find(found[i].taxicab_no), i);
+    }
+}
+
+TEST(TestTaxiCabBinary, FlatPairsPow8) {
+    uint64_t N = 100000000;
+    uint32_t R = 1000;
+    std::chrono::milliseconds timeout{10};
+    std::chrono::milliseconds check{1};
+
+    TaxiCabNumberFlat taxicab{N, R, 2, timeout, check};
+    taxicab.display_filename(false);
+    taxicab.search_engine(Engine::pairs);
+    taxicab.write_binary(true);
+    taxicab.run();
+
+    check_binary(taxicab, N, R);
+
+    TaxiCabReader reader{};
+    ASSERT_TRUE(reader.open(taxicab.report_file()));
+
+    // Ta(3)
+    std::size_t i = reader.find(87539319);
+    ASSERT_LT(i, reader.size());
+    ASSERT_EQ(reader.at(i).count, 3u);
+    ASSERT_EQ(reader.at(i).pairs[0], 167u);
+    ASSERT_EQ(reader.at(i).pairs[1], 436u);
+
+    ASSERT_EQ(reader.find(1730), reader.size());
+    ASSERT_EQ(reader.find(0), reader.size());
+    ASSERT_EQ(reader.find(UINT64_MAX), reader.size());
+}
+
+TEST(TestTaxiCabBinary, PipeHeapPow6) {
+    uint64_t N = 1000000;
+    uint32_t R = 100;
+    std::chrono::milliseconds timeout{10};
+    std::chrono::milliseconds check{1};
+
+    TaxiCabNumberPipe taxicab{N, R, 2, timeout, check};
+    taxicab.display_filename(false);
+    taxicab.search_engine(Engine::heap);
+    taxicab.write_binary(true);
+    taxicab.run();
+
+    check_binary(taxicab, N, R);
+}
+
+// cubes below 10 make no taxicab number, the file is a header and a single offset
+TEST(TestTaxiCabBinary, EmptyResult) {
+    uint64_t N = 10000;
+    uint32_t R = 10;
+    std::chrono::milliseconds timeout{10};
+    std::chrono::milliseconds check{1};
+
+    TaxiCabNumberFlat taxicab{N, R, 1, timeout, check};
+    taxicab.display_filename(false);
+    taxicab.write_binary(true);
+    taxicab.run();
+
+    ASSERT_TRUE(taxicab.found().empty());
+
+    TaxiCabReader reader{};
+    ASSERT_TRUE(reader.open(taxicab.report_file())) << taxicab.report_file();
+    ASSERT_EQ(reader.header().n, N);
+    ASSERT_EQ(reader.header().r, R);
+    ASSERT_EQ(reader.header().total_pairs, 0u);
+    ASSERT_EQ(reader.size(), 0u);
+    ASSERT_EQ(reader.find(1729), reader.size());
+}
+
+TEST(TestTaxiCabBinary, RejectsBadFiles) {
+    uint64_t N = 100000;
+    uint32_t R = 100;
+    std::chrono::milliseconds timeout{10};
+    std::chrono::milliseconds check{1};
+
+    TaxiCabNumberStr taxicab{N, R, 1, timeout, check};
+    taxicab.display_filename(false);
+    taxicab.write_binary(true);
+    taxicab.run();
+
+    std::string file_name = taxicab.report_file();
+    std::string content{};
+    {
+        std::ifstream in{file_name, std::ios::binary};
+        content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    TaxiCabReader reader{};
+    ASSERT_TRUE(reader.open(file_name));
+    ASSERT_EQ(reader.size(), 10u);
+    reader.close();
+
+    ASSERT_FALSE(reader.open("output/no_such_file.bin"));
+
+    // a truncated file
+    {
+        std::ofstream out{file_name, std::ios::binary | std::ios::trunc};
+        out.write(content.data(), content.size() - 8);
+    }
+    ASSERT_FALSE(reader.open(file_name));
+
+    // a json file
+    {
+        std::ofstream out{file_name, std::ios::binary | std::ios::trunc};
+        out << std::string(200, '{');
+    }
+    ASSERT_FALSE(reader.open(file_name));
+    ASSERT_FALSE(reader.is_open());
+}
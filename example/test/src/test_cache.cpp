@@ -0,0 +1,119 @@
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <fstream>
+#include <sys/stat.h>
+#include <dirent.h>
+#include "../../include/taxicab_number.h"
+#include "../../include/taxicab_reader.h"
+#include "../include/test_common.h"
+
+// an empty cache for every test
+std::string empty_cache(const std::string& name) {
+    std::string dir = "output/" + name;
+    DIR* files = ::opendir(dir.c_str());
+
+    if (files != nullptr) {
+        for (struct dirent* entry = ::readdir(files); entry != nullptr; entry = ::readdir(files)) {
+            std::string file_name{entry->d_name};
+            if (file_name != "." && file_name != "..") {
+                std::remove((dir + "/" + file_name).c_str());
+            }
+        }
+        ::closedir(files);
+    }
+
+    return dir;
+}
+
+// a binary run, cached if dir is given
+template<typename U>
+std::unique_ptr<U> run_cached(const uint64_t N, const uint32_t R, const Engine engine, const std::string& dir) {
+    std::chrono::milliseconds timeout{10};
+    std::chrono::milliseconds check{1};
+
+    std::unique_ptr<U> taxicab{new U{N, R, 2, timeout, check}};
+    taxicab->display_filename(false);
+    taxicab->search_engine(engine);
+    taxicab->write_binary(true);
+    taxicab->cache_dir(dir);
+    taxicab->run();
+
+    return taxicab;
+}
+
+// the numbers and the count of all numbers with cubes against a run without the cache
+template<typename U>
+void check_cached(U& cached, const uint64_t N, const uint32_t R) {
+    TaxiCabReader cached_file{};
+    ASSERT_TRUE(cached_file.open(cached.report_file()));
+    uint64_t total_cubes = cached_file.header().total_cubes;
+    cached_file.close();
+
+    auto whole = run_cached<U>(N, R, Engine::pairs, "");
+    TaxiCabReader whole_file{};
+    ASSERT_TRUE(whole_file.open(whole->report_file()));
+    ASSERT_EQ(total_cubes, whole_file.header().total_cubes);
+
+    expect_same_taxicabs(cached.found(), whole->found());
+}
+
+TEST(TestTaxiCabCache, MissHit) {
+    std::string dir = empty_cache("cache_hit");
+
+    auto first = run_cached<TaxiCabNumberFlat>(100000000, 1000, Engine::heap, dir);
+    ASSERT_FALSE(first->from_cache());
+
+    // any solution and engine
+    auto second = run_cached<TaxiCabNumberStr>(100000000, 1000, Engine::brute, dir);
+    ASSERT_TRUE(second->from_cache());
+    ASSERT_EQ(second->found().size(), taxicab_count(100000000));
+    check_cached(*second, 100000000, 1000);
+}
+
+TEST(TestTaxiCabCache, SmallerRun) {
+    std::string dir = empty_cache("cache_smaller");
+
+    run_cached<TaxiCabNumberPipe>(1000000000, 1000, Engine::window, dir);
+
+    // fewer numbers, fewer cubes
+    auto cubes = run_cached<TaxiCabNumberFlat>(100000000, 100, Engine::pairs, dir);
+    ASSERT_TRUE(cubes->from_cache());
+    check_cached(*cubes, 100000000, 100);
+
+    // 1000^3 is above 10^8, more cubes find nothing new
+    auto range = run_cached<TaxiCabNumberFlat>(100000000, 100000, Engine::pairs, dir);
+    ASSERT_TRUE(range->from_cache());
+    check_cached(*range, 100000000, 100000);
+}
+
+TEST(TestTaxiCabCache, LargerRun) {
+    std::string dir = empty_cache("cache_larger");
+
+    run_cached<TaxiCabNumberFlat>(10000000, 100, Engine::pairs, dir);
+
+    auto numbers = run_cached<TaxiCabNumberFlat>(100000000, 100, Engine::pairs, dir);
+    ASSERT_FALSE(numbers->from_cache());
+
+    auto cubes = run_cached<TaxiCabNumberFlat>(10000000, 1000, Engine::pairs, dir);
+    ASSERT_FALSE(cubes->from_cache());
+
+    // saved by the run before
+    auto again = run_cached<TaxiCabNumberFlat>(10000000, 1000, Engine::pairs, dir);
+    ASSERT_TRUE(again->from_cache());
+}
+
+TEST(TestTaxiCabCache, SkipsBadFile) {
+    std::string dir = empty_cache("cache_bad");
+
+    run_cached<TaxiCabNumberFlat>(100000000, 1000, Engine::pairs, dir);
+
+    // the smallest covering file is corrupt, the larger one answers
+    {
+        std::ofstream out{dir + "/taxicab_10000000_100_v1.bin", std::ios::binary | std::ios::trunc};
+        out << std::string(200, '{');
+    }
+
+    auto cached = run_cached<TaxiCabNumberFlat>(10000000, 100, Engine::pairs, dir);
+    ASSERT_TRUE(cached->from_cache());
+    check_cached(*cached, 10000000, 100);
+}
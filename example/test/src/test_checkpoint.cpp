@@ -0,0 +1,127 @@
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include "../../include/taxicab_number.h"
+#include "../include/test_common.h"
+
+bool file_exists(const std::string& file_name) {
+    std::ifstream in_file{file_name};
+    return in_file.is_open();
+}
+
+// many short segments give the result of one
+TEST(TestTaxiCabCheckpoint, Segments) {
+    uint64_t N = 100000000;
+    uint32_t R = 1000;
+    std::chrono::milliseconds timeout{10};
+    std::chrono::milliseconds check{1};
+
+    TaxiCabNumberFlat taxicab{N, R, 2, timeout, check};
+    taxicab.display_filename(false);
+    taxicab.search_engine(Engine::pairs);
+    taxicab.checkpoint_interval(std::chrono::milliseconds{1});
+    taxicab.run();
+
+    auto& found = taxicab.found();
+    ASSERT_EQ(found.size(), taxicab_count(N));
+    ASSERT_TRUE(check_taxicab(found));
+    ASSERT_FALSE(file_exists(taxicab.checkpoint_file()));
+}
+
+// a run stopped halfway is resumed by another object with more consumers
+TEST(TestTaxiCabCheckpoint, StopResume) {
+    uint64_t N = UINT64_C(100000000000);
+    uint32_t R = 10000;
+    std::chrono::milliseconds timeout{10};
+    std::chrono::milliseconds check{1};
+
+    TaxiCabNumberStr whole{N, R, 1, timeout, check};
+    whole.display_filename(false);
+    whole.search_engine(Engine::window);
+    whole.run();
+
+    TaxiCabNumberStr stopped{N, R, 1, timeout, check};
+    stopped.display_filename(false);
+    stopped.search_engine(Engine::window);
+    stopped.checkpoint_interval(std::chrono::seconds{60});
+
+    std::thread run{[&stopped]() { stopped.run(); }};
+    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+    stopped.stop();
+    run.join();
+
+    ASSERT_TRUE(stopped.report_file().empty());
+    ASSERT_TRUE(file_exists(stopped.checkpoint_file()));
+
+    TaxiCabNumberStr resumed{N, R, 1, timeout, check};
+    resumed.display_filename(false);
+    resumed.search_engine(Engine::window);
+    resumed.consumer_threads(2);
+    resumed.checkpoint_interval(std::chrono::seconds{60});
+    ASSERT_TRUE(resumed.resume());
+    resumed.run();
+
+    expect_same_taxicabs(resumed.found(), whole.found());
+
+    ASSERT_FALSE(file_exists(resumed.checkpoint_file()));
+}
+
+TEST(TestTaxiCabCheckpoint, OtherRun) {
+    uint64_t N = 1000000;
+    uint32_t R = 100;
+    std::chrono::milliseconds timeout{10};
+    std::chrono::milliseconds check{1};
+
+    // stopped before the first chunk
+    TaxiCabNumberFlat stopped{N, R, 2, timeout, check};
+    stopped.display_filename(false);
+    stopped.search_engine(Engine::pairs);
+    stopped.stop();
+    stopped.run();
+    ASSERT_TRUE(stopped.report_file().empty());
+
+    TaxiCabNumberFlat bigger{10 * N, R, 2, timeout, check};
+    bigger.search_engine(Engine::pairs);
+    ASSERT_FALSE(bigger.resume());
+
+    TaxiCabNumberFlat heap{N, R, 2, timeout, check};
+    heap.search_engine(Engine::heap);
+    ASSERT_FALSE(heap.resume());
+
+    TaxiCabNumberFlat same{N, R, 2, timeout, check};
+    same.display_filename(false);
+    same.search_engine(Engine::pairs);
+    same.checkpoint_interval(std::chrono::seconds{60});
+    ASSERT_TRUE(same.resume());
+    same.run();
+
+    auto& found = same.found();
+    ASSERT_EQ(found.size(), taxicab_count(N));
+    ASSERT_TRUE(check_taxicab(found));
+}
+
+TEST(TestTaxiCabCheckpoint, Truncated) {
+    uint64_t N = 1000000;
+    uint32_t R = 100;
+    std::chrono::milliseconds timeout{10};
+    std::chrono::milliseconds check{1};
+
+    TaxiCabNumberInt stopped{N, R, 1, timeout, check};
+    stopped.display_filename(false);
+    stopped.search_engine(Engine::pairs);
+    stopped.stop();
+    stopped.run();
+
+    {
+        std::ofstream out_file{stopped.checkpoint_file(), std::ios::out | std::ios::app | std::ios::binary};
+        out_file << 'x';
+    }
+
+    TaxiCabNumberInt resumed{N, R, 1, timeout, check};
+    resumed.search_engine(Engine::pairs);
+    ASSERT_FALSE(resumed.resume());
+
+    std::remove(stopped.checkpoint_file().c_str());
+    ASSERT_FALSE(resumed.resume());
+}
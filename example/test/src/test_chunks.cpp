@@ -0,0 +1,70 @@
+#include "gtest/gtest.h"
+#include <thread>
+#include "../../include/taxicab_number.h"
+#include "../include/test_common.h"
+
+TEST(TestChunkCursor, CoversRangeOnce) {
+    ChunkCursor chunks{};
+    const uint64_t first = 1;
+    const uint64_t last = 100001;
+    const uint32_t n_threads = 4;
+    std::vector<std::atomic<int>> seen(last);
+    std::vector<std::thread> threads{};
+
+    chunks.reset(first, last, n_threads, 16);
+
+    for (uint32_t t = 0; t < n_threads; ++t) {
+        threads.push_back(std::thread{[&chunks, &seen]() {
+            uint64_t start = 0;
+            uint64_t end = 0;
+
+            while (chunks.next(start, end)) {
+                for (uint64_t i = start; i < end; ++i) {
+                    ++seen[i];
+                }
+            }
+        }});
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(seen[0], 0);
+    for (uint64_t i = first; i < last; ++i) {
+        ASSERT_EQ(seen[i], 1);
+    }
+}
+
+TEST(TestChunkCursor, GuidedChunks) {
+    ChunkCursor chunks{};
+    uint64_t start = 0;
+    uint64_t end = 0;
+    uint64_t previous = 1000000;
+    int count = 0;
+
+    chunks.reset(0, 1000000, 2, 100);
+
+    while (chunks.next(start, end)) {
+        ASSERT_LE(end - start, previous);
+        ASSERT_TRUE(end - start >= 100 || end == 1000000);
+        previous = end - start;
+        ++count;
+    }
+
+    std::cout << "1000000 in " << count << " chunks\n";
+    ASSERT_LT(count, 1000);
+}
+
+// 1729 is in the N % T remainder of an equal split
+TEST(TestChunkCursor, RemainderIsSearched) {
+    std::chrono::milliseconds timeout{10};
+    std::chrono::milliseconds check{1};
+
+    TaxiCabNumberStr taxicab{1729, 13, 5, timeout, check};
+    taxicab.display_filename(false);
+    taxicab.run();
+
+    ASSERT_EQ(taxicab.found().size(), 1);
+    ASSERT_EQ(taxicab.found()[0].taxicab_no, 1729);
+}
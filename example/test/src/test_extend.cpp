@@ -0,0 +1,110 @@
+#include "gtest/gtest.h"
+#include "../../include/taxicab_number.h"
+#include "../../include/taxicab_reader.h"
+#include "../include/test_common.h"
+
+// the header of a report, before a run in the same second writes a file of the same name
+TaxiCabFileHeader header_of(const std::string& file_name) {
+    TaxiCabReader reader{};
+    EXPECT_TRUE(reader.open(file_name));
+    return reader.is_open() ? reader.header() : TaxiCabFileHeader{};
+}
+
+// a run of U to a binary file, extending the results of earlier if given
+template<typename U>
+std::unique_ptr<U> run_binary(const uint64_t N, const uint32_t R, const Engine engine, const std::string& earlier="") {
+    std::chrono::milliseconds timeout{10};
+    std::chrono::milliseconds check{1};
+
+    std::unique_ptr<U> taxicab{new U{N, R, 2, timeout, check}};
+    taxicab->display_filename(false);
+    taxicab->search_engine(engine);
+    taxicab->write_binary(true);
+
+    if (!earlier.empty()) {
+        EXPECT_TRUE(taxicab->extend(earlier));
+    }
+
+    taxicab->run();
+    return taxicab;
+}
+
+// the extended run against a whole run of the same N and R
+template<typename U>
+void check_extended(U& extended, const TaxiCabFileHeader& extended_header, U& whole) {
+    expect_same_taxicabs(extended.found(), whole.found());
+
+    TaxiCabFileHeader whole_header = header_of(whole.report_file());
+    ASSERT_EQ(extended_header.n, whole_header.n);
+    ASSERT_EQ(extended_header.total_cubes, whole_header.total_cubes);
+    ASSERT_EQ(extended_header.total_taxicabs, whole_header.total_taxicabs);
+    ASSERT_EQ(extended_header.total_pairs, whole_header.total_pairs);
+}
+
+TEST(TestTaxiCabExtend, FlatPairsRange) {
+    auto earlier = run_binary<TaxiCabNumberFlat>(10000000, 1000, Engine::pairs);
+    auto extended = run_binary<TaxiCabNumberFlat>(100000000, 1000, Engine::pairs, earlier->report_file());
+    TaxiCabFileHeader header = header_of(extended->report_file());
+    auto whole = run_binary<TaxiCabNumberFlat>(100000000, 1000, Engine::pairs);
+
+    ASSERT_EQ(extended->found().size(), taxicab_count(100000000));
+    check_extended(*extended, header, *whole);
+}
+
+// R = 100 misses the cubes from 100^3 on, which reach sums far below 10^8
+// cubes below 10 make no taxicab number, the earlier file holds none
+TEST(TestTaxiCabExtend, EmptyEarlier) {
+    auto earlier = run_binary<TaxiCabNumberFlat>(10000, 10, Engine::pairs);
+    ASSERT_TRUE(earlier->found().empty());
+
+    auto extended = run_binary<TaxiCabNumberFlat>(1000000, 100, Engine::pairs, earlier->report_file());
+    TaxiCabFileHeader header = header_of(extended->report_file());
+    auto whole = run_binary<TaxiCabNumberFlat>(1000000, 100, Engine::pairs);
+
+    ASSERT_EQ(extended->found().size(), taxicab_count(1000000));
+    check_extended(*extended, header, *whole);
+}
+
+TEST(TestTaxiCabExtend, IntHeapCubes) {
+    auto earlier = run_binary<TaxiCabNumberInt>(100000000, 100, Engine::heap);
+    auto extended = run_binary<TaxiCabNumberInt>(100000000, 1000, Engine::heap, earlier->report_file());
+    TaxiCabFileHeader header = header_of(extended->report_file());
+    auto whole = run_binary<TaxiCabNumberInt>(100000000, 1000, Engine::heap);
+
+    ASSERT_LT(earlier->found().size(), whole->found().size());
+    check_extended(*extended, header, *whole);
+}
+
+// the earlier run's engine does not matter
+TEST(TestTaxiCabExtend, PipeWindowBoth) {
+    auto earlier = run_binary<TaxiCabNumberPipe>(10000000, 100, Engine::pairs);
+    auto extended = run_binary<TaxiCabNumberPipe>(1000000000, 1000, Engine::window, earlier->report_file());
+    TaxiCabFileHeader header = header_of(extended->report_file());
+    auto whole = run_binary<TaxiCabNumberPipe>(1000000000, 1000, Engine::window);
+
+    check_extended(*extended, header, *whole);
+}
+
+TEST(TestTaxiCabExtend, StrBruteRange) {
+    auto earlier = run_binary<TaxiCabNumberStr>(100000, 100, Engine::brute);
+    auto extended = run_binary<TaxiCabNumberStr>(1000000, 100, Engine::brute, earlier->report_file());
+    TaxiCabFileHeader header = header_of(extended->report_file());
+    auto whole = run_binary<TaxiCabNumberStr>(1000000, 100, Engine::brute);
+
+    check_extended(*extended, header, *whole);
+}
+
+TEST(TestTaxiCabExtend, LargerRun) {
+    std::chrono::milliseconds timeout{10};
+    std::chrono::milliseconds check{1};
+    auto earlier = run_binary<TaxiCabNumberFlat>(10000000, 1000, Engine::pairs);
+
+    TaxiCabNumberFlat smaller_n{1000000, 1000, 2, timeout, check};
+    ASSERT_FALSE(smaller_n.extend(earlier->report_file()));
+
+    TaxiCabNumberFlat smaller_r{100000000, 100, 2, timeout, check};
+    ASSERT_FALSE(smaller_r.extend(earlier->report_file()));
+
+    TaxiCabNumberFlat no_file{100000000, 1000, 2, timeout, check};
+    ASSERT_FALSE(no_file.extend("output/none.bin"));
+}
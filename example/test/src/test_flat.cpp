@@ -0,0 +1,39 @@
+#include "gtest/gtest.h"
+#include "../../include/taxicab_number.h"
+#include "../include/test_common.h"
+
+CommonTests<TaxiCabNumberFlat> test_taxicab_flat{"taxicab_flat"};
+CommonTests<TaxiCabNumberFlat> test_flat_pairs{"flat_pairs", Engine::pairs, 2};
+
+TEST(TestTaxiCabFlat, SizePow2) {
+    test_taxicab_flat.test_size_small(2, 1, 1);
+}
+
+TEST(TestTaxiCabFlat, SizePow5) {
+    test_taxicab_flat.test_size_big(5, 2, 2);
+}
+
+// Ta(3) = 87539319 has three pairs
+TEST(TestTaxiCabFlat, PairsSizePow8) {
+    test_flat_pairs.test_size_big(8, 3, 2);
+}
+
+TEST(TestTaxiCabFlat, SameAsStr) {
+    uint32_t N = 1000000;
+    uint32_t R = 100;
+    std::chrono::milliseconds timeout{10};
+    std::chrono::milliseconds check{1};
+
+    TaxiCabNumberStr str{N, R, 2, timeout, check};
+    str.display_filename(false);
+    str.search_engine(Engine::pairs);
+    str.run();
+
+    // the table grows several times on the way
+    TaxiCabNumberFlat flat{N, R, 2, timeout, check};
+    flat.display_filename(false);
+    flat.search_engine(Engine::pairs);
+    flat.run();
+
+    expect_same_taxicabs(flat.found(), str.found());
+}
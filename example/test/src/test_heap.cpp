@@ -0,0 +1,53 @@
+#include "gtest/gtest.h"
+#include <set>
+#include "../../include/taxicab_number.h"
+#include "../include/test_common.h"
+
+CommonTests<TaxiCabNumberStr> test_heap_str{"heap_str", Engine::heap};
+CommonTests<TaxiCabNumberInt> test_heap_int{"heap_int", Engine::heap};
+CommonTests<TaxiCabNumberPipe> test_heap_pipe{"heap_pipe", Engine::heap};
+
+TEST(TestTaxiCabHeap, SizePow2) {
+    test_heap_str.test_size_small(2, 1, 1);
+}
+
+TEST(TestTaxiCabHeap, StrSizePow6) {
+    test_heap_str.test_size_big(6, 2, 3);
+}
+
+TEST(TestTaxiCabHeap, StrSizePow8) {
+    test_heap_str.test_size_big(8, 3, 4);
+}
+
+TEST(TestTaxiCabHeap, IntSizePow8) {
+    test_heap_int.test_size_big(8, 3, 1);
+}
+
+TEST(TestTaxiCabHeap, PipeSizePow8) {
+    test_heap_pipe.test_size_big(8, 3, 2);
+}
+
+// every distinct sum is counted exactly once over the producers' ranges
+TEST(TestTaxiCabHeap, DistinctSums) {
+    uint32_t N = 10000000;
+    uint32_t R = 1000;
+    std::chrono::milliseconds timeout{10};
+    std::chrono::milliseconds check{1};
+    std::set<uint64_t> sums{};
+
+    for (uint64_t a = 1; a < R; ++a) {
+        for (uint64_t b = a; b < R && a * a * a + b * b * b <= N; ++b) {
+            sums.insert(a * a * a + b * b * b);
+        }
+    }
+
+    for (uint32_t t = 1; t <= 5; ++t) {
+        TaxiCabNumberStr taxicab{N, R, t, timeout, check};
+        taxicab.display_filename(false);
+        taxicab.search_engine(Engine::heap);
+        taxicab.run();
+
+        ASSERT_EQ(taxicab.size_all(0), sums.size());
+        ASSERT_EQ(taxicab.found().size(), taxicab_count(N));
+    }
+}
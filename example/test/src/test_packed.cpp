@@ -0,0 +1,92 @@
+#include "gtest/gtest.h"
+#include "../../include/taxicab_number.h"
+#include "../include/test_common.h"
+
+// Ta(5) = 48988659276962496, its cubes need a range of 10^6 and the arena
+TEST(TestTaxiCabPacked, FivePairs) {
+    std::vector<CubePair> ta5{{38787, 365757}, {107839, 362753}, {205292, 342952}, {221424, 336588}, {231518, 331954}};
+    PackedPairs pairs{1000000};
+
+    uint64_t value = pairs.pack(ta5[0].first, ta5[0].second);
+    ASSERT_EQ(pairs.count(value), 1u);
+    ASSERT_EQ(pairs.unpack(value), ta5[0]);
+
+    for (std::size_t p = 1; p < ta5.size(); ++p) {
+        value = pairs.add(value, ta5[p].first, ta5[p].second);
+        ASSERT_EQ(pairs.count(value), p + 1);
+    }
+
+    // a pair already there is ignored
+    value = pairs.add(value, ta5[2].first, ta5[2].second);
+    ASSERT_EQ(pairs.count(value), ta5.size());
+
+    std::vector<CubePair> found;
+    pairs.for_each(value, [&found](const CubePair& ab) { found.push_back(ab); });
+    ASSERT_EQ(found, ta5);
+}
+
+// two numbers growing in turn move their blocks to the end of the arena
+TEST(TestTaxiCabPacked, InterleavedBlocks) {
+    PackedPairs pairs{1000};
+    uint64_t x = pairs.pack(1, 12);
+    uint64_t y = pairs.pack(2, 16);
+
+    x = pairs.add(x, 9, 10);
+    y = pairs.add(y, 9, 15);
+    x = pairs.add(x, 3, 20);
+    y = pairs.add(y, 4, 22);
+    x = pairs.add(x, 5, 30);
+
+    std::vector<CubePair> xs;
+    std::vector<CubePair> ys;
+    pairs.for_each(x, [&xs](const CubePair& ab) { xs.push_back(ab); });
+    pairs.for_each(y, [&ys](const CubePair& ab) { ys.push_back(ab); });
+
+    ASSERT_EQ(xs, (std::vector<CubePair>{{1, 12}, {9, 10}, {3, 20}, {5, 30}}));
+    ASSERT_EQ(ys, (std::vector<CubePair>{{2, 16}, {9, 15}, {4, 22}}));
+
+    pairs.clear();
+    ASSERT_EQ(pairs.arena_size(), 0u);
+}
+
+// Ta(4) = 6963472309248 has four pairs, the old 10-bit fields held three of cubes below 1024
+TEST(TestTaxiCabPacked, IntFindsTa4) {
+    uint64_t ta4 = UINT64_C(6963472309248);
+    std::chrono::milliseconds timeout{10};
+    std::chrono::milliseconds check{1};
+
+    TaxiCabNumberInt taxicab{ta4, 19084, 1, timeout, check};
+    taxicab.display_filename(false);
+
+    // the producer and the consumer in turn on this thread
+    std::atomic<bool> loop{false};
+    taxicab.find_taxicab_number(ta4, ta4 + 1, 19084);
+    taxicab.save_taxicab_number(loop, 0);
+    taxicab.report_taxicab_number(4);
+
+    auto& found = taxicab.found();
+    ASSERT_EQ(found.size(), 1u);
+    ASSERT_EQ(found[0].taxicab_no, ta4);
+    ASSERT_EQ(found[0].cube, (std::vector<CubePair>{{2421, 19083}, {5436, 18948}, {10200, 18072}, {13322, 16630}}));
+}
+
+// cubes of 14 bits, 87539319 has three pairs
+TEST(TestTaxiCabPacked, IntSameAsFlat) {
+    uint64_t N = UINT64_C(1000000000);
+    uint32_t R = 10000;
+    std::chrono::milliseconds timeout{10};
+    std::chrono::milliseconds check{1};
+
+    TaxiCabNumberFlat flat{N, R, 2, timeout, check};
+    flat.display_filename(false);
+    flat.search_engine(Engine::pairs);
+    flat.run();
+
+    TaxiCabNumberInt packed{N, R, 2, timeout, check};
+    packed.display_filename(false);
+    packed.search_engine(Engine::pairs);
+    packed.consumer_threads(3);
+    packed.run();
+
+    expect_same_taxicabs(packed.found(), flat.found());
+}
@@ -0,0 +1,46 @@
+#include "gtest/gtest.h"
+#include "../../include/taxicab_number.h"
+#include "../include/test_common.h"
+
+// the pairs engine is fast enough for the whole reference range
+CommonTests<TaxiCabNumberStr> test_pairs_str{"pairs_str", Engine::pairs};
+CommonTests<TaxiCabNumberInt> test_pairs_int{"pairs_int", Engine::pairs};
+CommonTests<TaxiCabNumberPipe> test_pairs_pipe{"pairs_pipe", Engine::pairs};
+
+TEST(TestTaxiCabPairs, SizePow2) {
+    test_pairs_str.test_size_small(2, 1, 1);
+}
+
+TEST(TestTaxiCabPairs, StrSizePow6) {
+    test_pairs_str.test_size_big(6, 2, 3);
+}
+
+TEST(TestTaxiCabPairs, StrSizePow8) {
+    test_pairs_str.test_size_big(8, 3, 4);
+}
+
+TEST(TestTaxiCabPairs, IntSizePow8) {
+    test_pairs_int.test_size_big(8, 3, 2);
+}
+
+TEST(TestTaxiCabPairs, PipeSizePow8) {
+    test_pairs_pipe.test_size_big(8, 3, 4);
+}
+
+TEST(TestTaxiCabPairs, SameAsBrute) {
+    uint32_t N = 100000;
+    uint32_t R = 100;
+    std::chrono::milliseconds timeout{10};
+    std::chrono::milliseconds check{1};
+
+    TaxiCabNumberStr brute{N, R, 1, timeout, check};
+    brute.display_filename(false);
+    brute.run();
+
+    TaxiCabNumberStr pairs{N, R, 3, timeout, check};
+    pairs.display_filename(false);
+    pairs.search_engine(Engine::pairs);
+    pairs.run();
+
+    expect_same_taxicabs(pairs.found(), brute.found());
+}
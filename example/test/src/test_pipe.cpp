@@ -0,0 +1,74 @@
+#include "gtest/gtest.h"
+#include "../../include/taxicab_number.h"
+#include "../include/test_common.h"
+
+CommonTests<TaxiCabNumberPipe> test_taxicab_pipe{"taxicab_pipe"};
+
+TEST(TestTaxiCabPipe, SizePow2) {
+    test_taxicab_pipe.test_size_small(2, 1, 1);
+}
+
+TEST(TestTaxiCabPipe, SizePow4) {
+    test_taxicab_pipe.test_size_big(4, 2, 1);
+}
+
+TEST(TestTaxiCabPipe, SizePow5) {
+    test_taxicab_pipe.test_size_big(5, 2, 2);
+}
+
+TEST(TestTaxiCabPipe, SizePow6) {
+    test_taxicab_pipe.test_size_big(6, 2, 4);
+}
+
+TEST(TestTaxiCabPipe, StageThreads) {
+    uint32_t N = std::pow(10, 6);
+    uint32_t R = std::pow(10, 2);
+    std::chrono::milliseconds timeout{10};
+    std::chrono::milliseconds check{1};
+
+    TaxiCabNumberPipe taxicab{N, R, 3, timeout, check};
+    taxicab.display_filename(false);
+    taxicab.write_json(false);
+    taxicab.format_threads(4);
+
+    taxicab.run();
+
+    auto& found = taxicab.found();
+    ASSERT_EQ(found.size(), taxicab_count(N));
+    ASSERT_TRUE(check_taxicab(found));
+
+    auto& stats = taxicab.stats();
+    ASSERT_EQ(stats.size(), 4);
+    ASSERT_EQ(stats[0].name, "search");
+    ASSERT_EQ(stats[0].threads, 3);
+    ASSERT_EQ(stats[2].threads, 4);
+    // nothing is lost between the stages
+    ASSERT_EQ(stats[0].items, stats[1].items);
+    ASSERT_EQ(stats[2].items, found.size());
+    ASSERT_EQ(stats[3].items, found.size());
+
+    for (auto& stage : stats) {
+        std::cout << stage.name << ": " << stage.items << " items, " << stage.throughput() << " items/s\n";
+    }
+}
+
+TEST(TestTaxiCabPipe, AggregateThreads) {
+    uint32_t N = 100000;
+    uint32_t R = 100;
+    std::chrono::milliseconds timeout{10};
+    std::chrono::milliseconds check{1};
+
+    TaxiCabNumberPipe single{N, R, 2, timeout, check};
+    single.display_filename(false);
+    single.run();
+
+    TaxiCabNumberPipe sharded{N, R, 2, timeout, check};
+    sharded.display_filename(false);
+    sharded.aggregate_threads(3);
+    sharded.format_threads(2);
+    sharded.run();
+
+    ASSERT_EQ(sharded.stats()[1].threads, 3);
+    ASSERT_EQ(sharded.stats()[1].items, single.stats()[1].items);
+    expect_same_taxicabs(sharded.found(), single.found());
+}
@@ -0,0 +1,117 @@
+#include "gtest/gtest.h"
+#include <fstream>
+#include <sstream>
+#include "../../include/taxicab_number.h"
+#include "../../include/report_writer.h"
+#include "../include/test_common.h"
+
+// the report without its elapsed time, which differs from run to run
+std::string read_report(const std::string& file_name) {
+    std::ifstream in_file{file_name};
+    std::ostringstream content;
+    std::string line;
+
+    while (std::getline(in_file, line)) {
+        std::size_t pos = line.find("elapsed");
+        content << (pos == std::string::npos ? line : line.substr(0, pos)) << '\n';
+    }
+
+    return content.str();
+}
+
+std::size_t count_of(const std::string& text, const std::string& word) {
+    std::size_t n = 0;
+
+    for (std::size_t pos = text.find(word); pos != std::string::npos; pos = text.find(word, pos + 1)) {
+        ++n;
+    }
+
+    return n;
+}
+
+TEST(TestTaxiCabReport, WriterFormat) {
+    ReportWriter out;
+
+    out.put_uint(0).put(' ').put_uint(UINT64_MAX).put(' ').put_uint(42, 5).put('|').put_right("ab", 4).put('|');
+
+    ASSERT_EQ(out.str(), "0 18446744073709551615    42|  ab|");
+}
+
+TEST(TestTaxiCabReport, TxtAllPairs) {
+    std::chrono::milliseconds timeout{10};
+    std::chrono::milliseconds check{1};
+    TaxiCabNumberFlat taxicab{1000, 10, 1, timeout, check};
+    Utility util{&taxicab};
+    ReportWriter out;
+
+    // Ta(3)
+    TaxiCab tc{87539319};
+    tc.cube = {{167, 436}, {228, 423}, {255, 414}};
+    util.write_txt_taxicab(out, 1, tc);
+
+    ASSERT_EQ(out.str(), "    1.\t  87539319 = 167^3 + 436^3 = 228^3 + 423^3 = 255^3 + 414^3\n");
+}
+
+// blocks larger than the buffer, in order, across several flushes
+TEST(TestTaxiCabReport, WriterFile) {
+    std::string file_name = "output/report_writer.txt";
+    std::string block(ReportWriter::BUFFER_SIZE + 3, 'x');
+    std::ostringstream expected;
+
+    {
+        ReportWriter out;
+        ASSERT_TRUE(out.open(file_name));
+
+        for (uint64_t i = 0; i < 300000; ++i) {
+            out.put_uint(i).put('\n');
+            expected << i << '\n';
+        }
+
+        out.put(block);
+        expected << block;
+        out.put_uint(7);
+        expected << 7;
+
+        ASSERT_TRUE(out.close());
+    }
+
+    std::ifstream in_file{file_name};
+    std::ostringstream content;
+    content << in_file.rdbuf();
+
+    ASSERT_EQ(content.str(), expected.str());
+}
+
+// the pipeline's ordered sink writes the same report as the flat table
+template<typename U>
+std::string report_of(const uint64_t N, const uint32_t R, const bool json) {
+    std::chrono::milliseconds timeout{10};
+    std::chrono::milliseconds check{1};
+
+    U taxicab{N, R, 2, timeout, check};
+    taxicab.display_filename(false);
+    taxicab.write_json(json);
+    taxicab.search_engine(Engine::pairs);
+    taxicab.run();
+
+    return read_report(taxicab.report_file());
+}
+
+TEST(TestTaxiCabReport, TxtPipeFlat) {
+    std::string flat = report_of<TaxiCabNumberFlat>(100000000, 1000, false);
+    std::string pipe = report_of<TaxiCabNumberPipe>(100000000, 1000, false);
+
+    ASSERT_EQ(flat, pipe);
+    ASSERT_EQ(count_of(flat, "\t"), taxicab_count(100000000));
+    ASSERT_NE(flat.find("87539319 = 167^3 + 436^3 = 228^3 + 423^3 = 255^3 + 414^3"), std::string::npos);
+}
+
+TEST(TestTaxiCabReport, JsonPipeFlat) {
+    std::string flat = report_of<TaxiCabNumberFlat>(100000000, 1000, true);
+    std::string pipe = report_of<TaxiCabNumberPipe>(100000000, 1000, true);
+
+    ASSERT_EQ(flat, pipe);
+    ASSERT_EQ(count_of(flat, "{\"taxicab\":"), taxicab_count(100000000));
+    ASSERT_NE(flat.find("{\"taxicab\":87539319,\"cubes\":[[167, 436],[228, 423],[255, 414]]}"), std::string::npos);
+    ASSERT_EQ(flat.substr(flat.size() - 4), "\n]}\n");
+}
@@ -0,0 +1,53 @@
+#include "gtest/gtest.h"
+#include "../../include/taxicab_number.h"
+#include "../include/test_common.h"
+
+// every consumer saves the numbers of its own partition
+CommonTests<TaxiCabNumberStr> test_shards_str{"shards_str", Engine::pairs, 4};
+CommonTests<TaxiCabNumberInt> test_shards_int{"shards_int", Engine::pairs, 3};
+
+TEST(TestTaxiCabShards, StrSizePow8) {
+    test_shards_str.test_size_big(8, 3, 2);
+}
+
+TEST(TestTaxiCabShards, IntSizePow8) {
+    test_shards_int.test_size_big(8, 3, 2);
+}
+
+TEST(TestTaxiCabShards, SameAsSingleConsumer) {
+    uint32_t N = 100000;
+    uint32_t R = 100;
+    std::chrono::milliseconds timeout{10};
+    std::chrono::milliseconds check{1};
+
+    TaxiCabNumberStr single{N, R, 2, timeout, check};
+    single.display_filename(false);
+    single.run();
+
+    TaxiCabNumberStr sharded{N, R, 2, timeout, check};
+    sharded.display_filename(false);
+    sharded.consumer_threads(5);
+    sharded.run();
+
+    expect_same_taxicabs(sharded.found(), single.found());
+}
+
+TEST(TestTaxiCabShards, RunAgainAfterClear) {
+    uint32_t N = 100000;
+    uint32_t R = 100;
+    std::chrono::milliseconds timeout{10};
+    std::chrono::milliseconds check{1};
+
+    TaxiCabNumberInt taxicab{N, R, 1, timeout, check};
+    taxicab.display_filename(false);
+    taxicab.search_engine(Engine::pairs);
+    taxicab.consumer_threads(4);
+    taxicab.run();
+    std::size_t first = taxicab.found().size();
+
+    taxicab.clear();
+    taxicab.run();
+
+    ASSERT_EQ(taxicab.found().size(), first);
+    ASSERT_EQ(first, 10u);
+}
@@ -0,0 +1,55 @@
+#include "gtest/gtest.h"
+#include "../../include/taxicab_number.h"
+#include "../../include/cube_kernel.h"
+#include "../include/test_common.h"
+
+// every level up to the CPU's against the scalar loop
+static const SimdLevel levels[] = {SimdLevel::scalar, SimdLevel::sse41, SimdLevel::avx2, SimdLevel::avx512};
+
+TEST(TestTaxiCabSimd, MatchEveryLane) {
+    const uint32_t n_range = 100;
+    std::vector<uint64_t> cubes(104, UINT64_MAX);
+
+    for (uint64_t k = 1; k < n_range; ++k) {
+        cubes[k - 1] = k * k * k;
+    }
+
+    for (SimdLevel level : levels) {
+        if (level > simd_detect()) {
+            continue;
+        }
+
+        CubeMatch match = simd_match(level);
+        std::vector<uint64_t> aligned(cubes.size() + 8);
+        uint64_t* table = aligned.data() + (64 - reinterpret_cast<uintptr_t>(aligned.data()) % 64) % 64 / sizeof(uint64_t);
+        std::copy(cubes.begin(), cubes.end(), table);
+
+        for (uint64_t k = 1; k < n_range; ++k) {
+            ASSERT_EQ(match(table, cubes.size(), k * k * k), k - 1) << simd_name(level);
+            ASSERT_EQ(match(table, cubes.size(), k * k * k + 1), cubes.size()) << simd_name(level);
+        }
+    }
+}
+
+TEST(TestTaxiCabSimd, SameAsScalar) {
+    uint64_t N = 200000;
+    uint32_t R = 61;
+    std::chrono::milliseconds timeout{10};
+    std::chrono::milliseconds check{1};
+
+    TaxiCabNumberStr scalar{N, R, 2, timeout, check};
+    scalar.display_filename(false);
+    ASSERT_EQ(scalar.simd_level(SimdLevel::scalar), SimdLevel::scalar);
+    scalar.run();
+
+    for (SimdLevel level : levels) {
+        TaxiCabNumberStr simd{N, R, 2, timeout, check};
+        simd.display_filename(false);
+        SimdLevel used = simd.simd_level(level);
+        ASSERT_LE(used, simd_detect());
+        simd.run();
+
+        SCOPED_TRACE(simd_name(used));
+        expect_same_taxicabs(simd.found(), scalar.found());
+    }
+}
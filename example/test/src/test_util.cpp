@@ -1,6 +1,6 @@
 #include "../include/test_util.h"
 
-int taxicab_count(uint32_t max) {
+int taxicab_count(uint64_t max) {
     int count = 0;
 
     for (auto& ref : ref_taxicab) {
@@ -0,0 +1,102 @@
+#include "gtest/gtest.h"
+#include <limits>
+#include "../../include/taxicab_number.h"
+#include "../../include/cube_math.h"
+#include "../include/test_common.h"
+
+// the search kernels of Base, for windows far beyond 32 bits
+class WideSearch : public TaxiCabNumberFlat {
+    public:
+        using Base::search_taxicab_heap;
+        using Base::search_taxicab_pairs;
+};
+
+TEST(TestTaxiCabWide, CubeChecked) {
+    uint64_t c = 0;
+
+    ASSERT_TRUE(cube_checked(2642245, c));
+    ASSERT_EQ(c, UINT64_C(18446724184312856125));
+    ASSERT_FALSE(cube_checked(2642246, c));
+    ASSERT_FALSE(cube_checked(std::numeric_limits<uint64_t>::max(), c));
+
+    uint64_t s = 0;
+    ASSERT_TRUE(sum_checked(UINT64_C(1000000000000000000), UINT64_C(1000000000000000000), s));
+    ASSERT_EQ(s, UINT64_C(2000000000000000000));
+    ASSERT_FALSE(sum_checked(std::numeric_limits<uint64_t>::max(), 1, s));
+}
+
+TEST(TestTaxiCabWide, CubeRoot) {
+    ASSERT_EQ(cube_root(0), 0u);
+    ASSERT_EQ(cube_root(7), 1u);
+    ASSERT_EQ(cube_root(8), 2u);
+    ASSERT_EQ(cube_root(UINT64_C(999999999999999999)), 999999u);
+    ASSERT_EQ(cube_root(UINT64_C(1000000000000000000)), 1000000u);
+    ASSERT_EQ(cube_root(UINT64_C(18446724184312856124)), 2642244u);
+    ASSERT_EQ(cube_root(UINT64_C(18446724184312856125)), 2642245u);
+    ASSERT_EQ(cube_root(std::numeric_limits<uint64_t>::max()), 2642245u);
+}
+
+TEST(TestTaxiCabWide, Pow10) {
+    uint64_t x = 0;
+
+    ASSERT_TRUE(pow10_checked(18, x));
+    ASSERT_EQ(x, UINT64_C(1000000000000000000));
+    ASSERT_TRUE(pow10_checked(19, x));
+    ASSERT_FALSE(pow10_checked(20, x));
+}
+
+// Ta(4) = 6963472309248, far beyond 32 bits
+TEST(TestTaxiCabWide, HeapWindowTa4) {
+    const uint64_t ta4 = UINT64_C(6963472309248);
+    std::vector<CubePair> cube{};
+
+    uint64_t count = WideSearch::search_taxicab_heap(ta4 - 1, ta4, 1000000, [&cube, ta4](const CubeSum& ta) {
+        ASSERT_EQ(std::get<0>(ta), ta4);
+        cube.push_back(CubePair{std::get<1>(ta), std::get<2>(ta)});
+    });
+
+    std::sort(cube.begin(), cube.end());
+    std::vector<CubePair> expected{{2421, 19083}, {5436, 18948}, {10200, 18072}, {13322, 16630}};
+
+    ASSERT_EQ(count, 1u);
+    ASSERT_EQ(cube, expected);
+}
+
+// the largest cubes of R = 10^6 without a wrap-around
+TEST(TestTaxiCabWide, PairsNearTop) {
+    const uint64_t n_max = UINT64_C(1999994000005999998);   // 2 * 999999^3
+    uint64_t sums = 0;
+    uint64_t last = 0;
+
+    WideSearch::search_taxicab_pairs(999990, 1000000, 0, n_max, 1000000, [&sums, &last](const CubeSum& ta) {
+        ++sums;
+        last = std::get<0>(ta);
+    });
+
+    ASSERT_EQ(sums, 55u);
+    ASSERT_EQ(last, n_max);
+}
+
+TEST(TestTaxiCabWide, RangeGuards) {
+    std::chrono::milliseconds timeout{10};
+    std::chrono::milliseconds check{1};
+
+    ASSERT_NO_THROW((TaxiCabNumberFlat{UINT64_C(1000000000000000000), 1000000, 1, timeout, check}));
+    ASSERT_THROW((TaxiCabNumberFlat{UINT64_C(1000000000000000000), 3000000, 1, timeout, check}), std::invalid_argument);
+    ASSERT_NO_THROW((TaxiCabNumberInt{UINT64_C(1000000000000000000), 1000000, 1, timeout, check}));
+    ASSERT_THROW((TaxiCabNumberInt{UINT64_C(1000000000000000000), 3000000, 1, timeout, check}), std::invalid_argument);
+}
+
+TEST(TestTaxiCabWide, FormatJson) {
+    std::chrono::milliseconds timeout{10};
+    std::chrono::milliseconds check{1};
+    TaxiCabNumberFlat taxicab{UINT64_C(10000000000000), 100000, 1, timeout, check};
+    Utility util{&taxicab};
+    ReportWriter dump;
+
+    TaxiCab tc{UINT64_C(6963472309248)};
+    tc.cube = {{2421, 19083}, {5436, 18948}, {10200, 18072}, {13322, 16630}};
+    util.write_json_taxicab(dump, tc);
+
+    ASSERT_EQ(dump.str(), "{\"taxicab\":6963472309248,\"cubes\":[[2421, 19083],[5436, 18948],[10200, 18072],[13322, 16630]]}");
+}
@@ -0,0 +1,70 @@
+#include "gtest/gtest.h"
+#include <set>
+#include "../../include/taxicab_number.h"
+#include "../include/test_common.h"
+
+CommonTests<TaxiCabNumberStr> test_window_str{"window_str", Engine::window};
+CommonTests<TaxiCabNumberInt> test_window_int{"window_int", Engine::window};
+CommonTests<TaxiCabNumberFlat> test_window_flat{"window_flat", Engine::window, 2};
+
+TEST(TestTaxiCabWindow, SizePow2) {
+    test_window_str.test_size_small(2, 1, 1);
+}
+
+TEST(TestTaxiCabWindow, StrSizePow6) {
+    test_window_str.test_size_big(6, 2, 3);
+}
+
+// 382 windows
+TEST(TestTaxiCabWindow, IntSizePow8) {
+    test_window_int.test_size_big(8, 3, 2);
+}
+
+TEST(TestTaxiCabWindow, FlatSizePow8) {
+    test_window_flat.test_size_big(8, 3, 4);
+}
+
+// every distinct sum is counted exactly once over the windows of the producers
+TEST(TestTaxiCabWindow, DistinctSums) {
+    uint64_t N = 10000000;
+    uint32_t R = 1000;
+    std::chrono::milliseconds timeout{10};
+    std::chrono::milliseconds check{1};
+    std::set<uint64_t> sums{};
+
+    for (uint64_t a = 1; a < R; ++a) {
+        for (uint64_t b = a; b < R && a * a * a + b * b * b <= N; ++b) {
+            sums.insert(a * a * a + b * b * b);
+        }
+    }
+
+    for (uint32_t t = 1; t <= 3; ++t) {
+        TaxiCabNumberStr taxicab{N, R, t, timeout, check};
+        taxicab.display_filename(false);
+        taxicab.search_engine(Engine::window);
+        taxicab.run();
+
+        ASSERT_EQ(taxicab.size_all(0), sums.size());
+        ASSERT_EQ(taxicab.found().size(), taxicab_count(N));
+    }
+}
+
+// a cube range below the taxicab range stops the pairs early
+TEST(TestTaxiCabWindow, SameAsPairs) {
+    uint64_t N = 50000000;
+    uint32_t R = 300;
+    std::chrono::milliseconds timeout{10};
+    std::chrono::milliseconds check{1};
+
+    TaxiCabNumberFlat pairs{N, R, 2, timeout, check};
+    pairs.display_filename(false);
+    pairs.search_engine(Engine::pairs);
+    pairs.run();
+
+    TaxiCabNumberFlat window{N, R, 3, timeout, check};
+    window.display_filename(false);
+    window.search_engine(Engine::window);
+    window.run();
+
+    expect_same_taxicabs(window.found(), pairs.found());
+}
@@ -0,0 +1,154 @@
+/*******************************************************************************
+ MIT License
+ Copyright (c) 2020 Orhan Kupusoglu
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+*******************************************************************************/
+
+/*!
+ * \anchor CoalescingQueue
+ *
+ * A keyed concurrent queue that holds at most one pending entry per key.
+ * A push for a key that is still queued merges into the pending entry instead of
+ * adding a new one, by default the latest value wins.
+ * Entries are popped in the order their keys first arrived, the queue never holds
+ * more entries than there are distinct keys.
+ * C++11
+ * [std::unordered_map](https://en.cppreference.com/w/cpp/container/unordered_map)
+ */
+
+#ifndef COALESCING_QUEUE_H
+#define COALESCING_QUEUE_H
+
+#include <queue>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+template<typename K, typename V, typename Hash = std::hash<K>>
+class CoalescingQueue {
+    public:
+        CoalescingQueue() = default;                                    // default constructor
+        CoalescingQueue(const CoalescingQueue&) = delete;               // copy constructor
+        CoalescingQueue& operator=(const CoalescingQueue&) = delete;    // copy assignment
+        CoalescingQueue(CoalescingQueue&&) = delete;                    // move constructor
+        CoalescingQueue& operator=(CoalescingQueue &&) = delete;        // move assignment
+
+        void clear() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            std::queue<K> blank;
+            std::swap(blank, _order);
+            _pending.clear();
+        }
+
+        // the latest value replaces a pending one
+        void push(K const& key, V const& value) {
+            push(key, value, [](V& pending, V const& incoming) { pending = incoming; });
+        }
+
+        // merge(V& pending, V const& incoming) folds value into the pending entry
+        template<typename Merge>
+        void push(K const& key, V const& value, Merge merge) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            auto it = _pending.find(key);
+
+            if (it != _pending.end()) {
+                merge(it->second, value);
+                ++_coalesced;
+                return;
+            }
+
+            _pending.emplace(key, value);
+            _order.push(key);
+            lock.unlock();
+            _condition.notify_one();
+        }
+
+        std::size_t size() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            return _order.size();
+        }
+
+        bool empty() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            return _order.empty();
+        }
+
+        // number of pushes merged into a pending entry
+        std::size_t coalesced() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            return _coalesced;
+        }
+
+        bool try_pop(K& key, V& value) {
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            if (_order.empty()) {
+                return false;
+            }
+
+            take(key, value);
+            return true;
+        }
+
+        void wait_and_pop(K& key, V& value) {
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            while (_order.empty()) {
+                _condition.wait(lock);
+            }
+
+            take(key, value);
+        }
+
+        bool wait_and_pop_while(K& key, V& value,
+            std::chrono::milliseconds timeout_duration=std::chrono::seconds(1),
+            const std::chrono::milliseconds& check_interval=std::chrono::milliseconds(10)) {
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            while (_order.empty()) {
+                if (_condition.wait_for(lock, check_interval) == std::cv_status::timeout) {
+                    timeout_duration -= check_interval;
+                    if (timeout_duration <= std::chrono::milliseconds::zero() ) {
+                        return false;
+                    }
+                }
+            }
+
+            take(key, value);
+            return true;
+        }
+
+    private:
+        void take(K& key, V& value) {
+            key = std::move(_order.front());
+            _order.pop();
+
+            auto it = _pending.find(key);
+            value = std::move(it->second);
+            _pending.erase(it);
+        }
+
+        std::size_t _coalesced = 0;
+        std::queue<K> _order;                           // keys in order of first arrival
+        std::unordered_map<K, V, Hash> _pending;
+        std::mutex _mutex;
+        std::condition_variable _condition;
+};
+
+#endif
@@ -30,18 +30,39 @@
  * [std::mutex](https://en.cppreference.com/w/cpp/thread/mutex)
  * [std::condition_variable](https://en.cppreference.com/w/cpp/thread/condition_variable)
  * [std::chrono::duration](https://en.cppreference.com/w/cpp/chrono/duration)
+ *
+ * pop_batch() trades a small, bounded latency for larger batches: it lingers until
+ * either max_n elements are queued or linger has passed since the oldest of them
+ * arrived, or since the call for elements queued before it, producers wake a
+ * lingering consumer only once the batch is full.
+ * Pushes read the clock only while a pop_batch() waits for its first element.
+ *
+ * The elements are kept in a std::queue by default, Storage selects another
+ * container with the same interface, for example a RingBuffer.
  */
 
 #ifndef CONCURRENT_QUEUE_H
 #define CONCURRENT_QUEUE_H
 
 #include <queue>
+#include <utility>
+#include <algorithm>
+#include <vector>
+#include <map>
+#include <cstdint>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 #include <chrono>
 
-template<typename T>
+// releases the memory of a std::queue, containers that keep theirs overload it
+template<typename Storage>
+void clear_storage(Storage& storage) {
+    Storage blank;
+    std::swap(blank, storage);
+}
+
+template<typename T, typename Storage = std::queue<T>>
 class ConcurrentQueue {
     public:
         ConcurrentQueue() = default;                                    // default constructor
@@ -52,15 +73,16 @@ class ConcurrentQueue {
 
         void clear() {
             std::unique_lock<std::mutex> lock(_mutex);
-            std::queue<T> blank;
-            std::swap(blank, _queue);
+            clear_storage(_queue);
         }
 
         void push(T const& data) {
-            std::unique_lock<std::mutex> lock(_mutex);
-            _queue.push(data);
-            lock.unlock();
-            _condition.notify_one();
+            emplace(data);
+        }
+
+        // for move-only elements, e.g. ObjectPool handles
+        void push(T&& data) {
+            emplace(std::move(data));
         }
 
         std::size_t size() {
@@ -115,10 +137,93 @@ class ConcurrentQueue {
             return true;
         }
 
+        // wakeups of lingering pop_batch() calls short of their max_n, spurious or after another consumer drained the queue
+        uint64_t batch_wakeups() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            return _batch_wakeups;
+        }
+
+        // appends at most max_n elements to values, returns their number
+        std::size_t pop_batch(std::vector<T>& values, std::size_t max_n,
+            const std::chrono::milliseconds& linger=std::chrono::milliseconds(1)) {
+            if (max_n == 0) {
+                return 0;
+            }
+
+            auto t_call = std::chrono::steady_clock::now();
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            while (true) {
+                ++_batch_callers;
+                while (_queue.empty()) {
+                    _condition.wait(lock);
+                }
+                --_batch_callers;
+
+                if (_queue.size() < max_n) {
+                    // the single sleep of the linger phase, pushes wake it only once its own batch is full
+                    // an arrival stamped before the call belongs to an earlier wait
+                    auto deadline = std::max(_first_arrival, t_call) + linger;
+                    std::condition_variable full;
+                    auto waiter = _batch_waiters.emplace(max_n, &full);
+
+                    while (_queue.size() < max_n) {
+                        if (full.wait_until(lock, deadline) == std::cv_status::timeout) {
+                            break;
+                        }
+                        if (_queue.size() < max_n) {
+                            ++_batch_wakeups;
+                        }
+                    }
+
+                    _batch_waiters.erase(waiter);
+                }
+
+                // another consumer may have drained the queue meanwhile
+                if (!_queue.empty()) {
+                    break;
+                }
+            }
+
+            std::size_t n = std::min(max_n, _queue.size());
+            values.reserve(values.size() + n);
+
+            for (std::size_t i = 0; i < n; ++i) {
+                values.push_back(std::move(_queue.front()));
+                _queue.pop();
+            }
+
+            return n;
+        }
+
     private:
-        std::queue<T> _queue;
+        template<typename U>
+        void emplace(U&& data) {
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            // only a pop_batch() waiting on an empty queue needs the time
+            if (_queue.empty() && _batch_callers > 0) {
+                _first_arrival = std::chrono::steady_clock::now();
+            }
+
+            _queue.push(std::forward<U>(data));
+
+            // the waiters in order of max_n, notified under the lock while their condition variables live
+            for (auto it = _batch_waiters.begin(); it != _batch_waiters.end() && it->first <= _queue.size(); ++it) {
+                it->second->notify_one();
+            }
+
+            lock.unlock();
+            _condition.notify_one();
+        }
+
+        Storage _queue;
         std::mutex _mutex;
         std::condition_variable _condition;
+        std::chrono::steady_clock::time_point _first_arrival;   // when the queue last became non-empty for a waiting pop_batch()
+        std::size_t _batch_callers = 0;                         // pop_batch() calls waiting on an empty queue
+        std::multimap<std::size_t, std::condition_variable*> _batch_waiters;    // lingering pop_batch() calls by max_n
+        uint64_t _batch_wakeups = 0;
 };
 
 #endif
@@ -0,0 +1,348 @@
+/*******************************************************************************
+ MIT License
+ Copyright (c) 2020 Orhan Kupusoglu
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+*******************************************************************************/
+
+/*!
+ * \anchor DelayQueue
+ *
+ * A concurrent queue whose elements become poppable only after their deadline.
+ * Pending elements live in a hierarchical timing wheel, six levels of 64 slots
+ * each, so insertion and expiry are O(1) and an occupancy bitmap per level finds
+ * the next slot to process without scanning.
+ * Time is counted in ticks of a configurable resolution, a deadline is rounded up
+ * to the next tick, hence an element is never delivered early and at most one tick
+ * late.
+ * wait_and_pop() sleeps until the earliest tick that needs processing, a push with
+ * an earlier deadline wakes it up.
+ * [Hashed and Hierarchical Timing Wheels](http://www.cs.columbia.edu/~nahum/w6998/papers/ton97-timing-wheels.pdf)
+ * C++11
+ * [std::condition_variable::wait_until](https://en.cppreference.com/w/cpp/thread/condition_variable/wait_until)
+ */
+
+#ifndef DELAY_QUEUE_H
+#define DELAY_QUEUE_H
+
+#include <cstdint>
+#include <algorithm>
+#include <deque>
+#include <vector>
+#include <limits>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#if __cplusplus > 201703L  // C++20
+#include <bit>
+#endif
+
+template<typename T>
+class DelayQueue {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        explicit DelayQueue(clock::duration resolution=std::chrono::milliseconds(1))
+           : _resolution{resolution},
+             _origin{clock::now()}
+        {}
+        DelayQueue(const DelayQueue&) = delete;                         // copy constructor
+        DelayQueue& operator=(const DelayQueue&) = delete;              // copy assignment
+        DelayQueue(DelayQueue&&) = delete;                              // move constructor
+        DelayQueue& operator=(DelayQueue &&) = delete;                  // move assignment
+
+        void clear() {
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            for (int level = 0; level < LEVELS; ++level) {
+                for (int slot = 0; slot < SLOTS; ++slot) {
+                    std::vector<Entry> blank;
+                    std::swap(blank, _wheel[level][slot]);
+                }
+                _occupied[level] = 0;
+            }
+
+            std::deque<T> blank;
+            std::swap(blank, _ready);
+            _pending = 0;
+        }
+
+        void push(T const& data, clock::time_point ready_at) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            uint64_t tick = to_tick(ready_at);
+
+            insert({tick, data});
+
+            // a sleeper only needs to know about a deadline earlier than its own
+            bool wake = tick < _sleep_tick;
+            lock.unlock();
+
+            if (wake) {
+                _condition.notify_one();
+            }
+        }
+
+        template<typename Rep, typename Period>
+        void push(T const& data, std::chrono::duration<Rep, Period> delay) {
+            push(data, clock::now() + std::chrono::duration_cast<clock::duration>(delay));
+        }
+
+        // pending and ready elements
+        std::size_t size() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            return _pending + _ready.size();
+        }
+
+        bool empty() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            return _pending == 0 && _ready.empty();
+        }
+
+        bool try_pop(T& value) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            advance(now_tick());
+
+            if (_ready.empty()) {
+                return false;
+            }
+
+            value = std::move(_ready.front());
+            _ready.pop_front();
+            return true;
+        }
+
+        void wait_and_pop(T& value) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            wait_until(lock, clock::time_point::max());
+            pop_ready(lock, value);
+        }
+
+        bool wait_and_pop_while(T& value,
+            std::chrono::milliseconds timeout_duration=std::chrono::seconds(1)) {
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            if (!wait_until(lock, clock::now() + timeout_duration)) {
+                return false;
+            }
+
+            pop_ready(lock, value);
+            return true;
+        }
+
+    private:
+        static const int LEVEL_BITS = 6;
+        static const int SLOTS = 1 << LEVEL_BITS;
+        static const int LEVELS = 6;
+
+        struct Entry {
+            uint64_t tick;
+            T data;
+        };
+
+        static int count_trailing_zero(uint64_t x) {
+#if __cplusplus > 201703L  // C++20
+            return std::countr_zero(x);
+#else
+            return __builtin_ctzll(x);
+#endif
+        }
+
+        static int count_leading_zero(uint64_t x) {
+#if __cplusplus > 201703L  // C++20
+            return std::countl_zero(x);
+#else
+            return __builtin_clzll(x);
+#endif
+        }
+
+        static uint64_t rotate_right(uint64_t x, int n) {
+            return n == 0 ? x : (x >> n) | (x << (64 - n));
+        }
+
+        // rounded up, an element is never due before its deadline
+        uint64_t to_tick(clock::time_point tp) const {
+            if (tp <= _origin) {
+                return 0;
+            }
+
+            uint64_t d = (tp - _origin).count();
+            uint64_t r = _resolution.count();
+            return (d + r - 1) / r;
+        }
+
+        uint64_t now_tick() const {
+            return (clock::now() - _origin).count() / _resolution.count();
+        }
+
+        clock::time_point from_tick(uint64_t tick) const {
+            return _origin + _resolution * static_cast<clock::rep>(tick);
+        }
+
+        void insert(Entry&& entry) {
+            if (entry.tick < _current) {
+                _ready.push_back(std::move(entry.data));
+                return;
+            }
+
+            uint64_t delta = entry.tick - _current;
+            uint64_t slot_tick = entry.tick;
+            int level = 0;
+
+            if (delta >= SLOTS) {
+                level = (63 - count_leading_zero(delta)) / LEVEL_BITS;
+
+                // beyond the wheel's span: park in the farthest slot, cascading puts it back
+                if (level >= LEVELS) {
+                    level = LEVELS - 1;
+                    slot_tick = _current + (uint64_t{1} << (LEVEL_BITS * LEVELS)) - 1;
+                }
+            }
+
+            int slot = (slot_tick >> (LEVEL_BITS * level)) & (SLOTS - 1);
+            _wheel[level][slot].push_back(std::move(entry));
+            _occupied[level] |= uint64_t{1} << slot;
+            ++_pending;
+        }
+
+        // the earliest tick at which a slot fires (level 0) or cascades (higher levels)
+        uint64_t next_event_tick() const {
+            uint64_t next = std::numeric_limits<uint64_t>::max();
+
+            for (int level = 0; level < LEVELS; ++level) {
+                if (_occupied[level] == 0) {
+                    continue;
+                }
+
+                int shift = LEVEL_BITS * level;
+                uint64_t base = (_current + (uint64_t{1} << shift) - 1) >> shift;
+                int j = count_trailing_zero(rotate_right(_occupied[level], base & (SLOTS - 1)));
+                uint64_t tick = (base + j) << shift;
+
+                if (tick < next) {
+                    next = tick;
+                }
+            }
+
+            return next;
+        }
+
+        void cascade(int level, int slot) {
+            std::vector<Entry> entries;
+            std::swap(entries, _wheel[level][slot]);
+            _occupied[level] &= ~(uint64_t{1} << slot);
+            _pending -= entries.size();
+
+            for (auto& entry : entries) {
+                insert(std::move(entry));
+            }
+        }
+
+        // process every tick up to and including now
+        void advance(uint64_t now) {
+            while (_pending > 0) {
+                uint64_t tick = next_event_tick();
+
+                if (tick > now) {
+                    break;
+                }
+
+                _current = tick;
+
+                for (int level = LEVELS - 1; level > 0; --level) {
+                    int shift = LEVEL_BITS * level;
+                    if ((tick & ((uint64_t{1} << shift) - 1)) == 0) {
+                        cascade(level, (tick >> shift) & (SLOTS - 1));
+                    }
+                }
+
+                int slot = tick & (SLOTS - 1);
+                std::vector<Entry>& due = _wheel[0][slot];
+                for (auto& entry : due) {
+                    _ready.push_back(std::move(entry.data));
+                }
+                _pending -= due.size();
+                due.clear();
+                _occupied[0] &= ~(uint64_t{1} << slot);
+
+                _current = tick + 1;
+            }
+
+            if (_current <= now) {
+                _current = now + 1;
+            }
+        }
+
+        // returns false if nothing became due before the deadline
+        bool wait_until(std::unique_lock<std::mutex>& lock, clock::time_point deadline) {
+            while (true) {
+                advance(now_tick());
+
+                if (!_ready.empty()) {
+                    return true;
+                }
+
+                clock::time_point wakeup = deadline;
+                if (_pending > 0) {
+                    uint64_t tick = next_event_tick();
+                    wakeup = std::min(wakeup, from_tick(tick));
+                    _sleep_tick = std::min(_sleep_tick, tick);
+                }
+
+                if (clock::now() >= deadline) {
+                    return false;
+                }
+
+                ++_waiting;
+                if (wakeup == clock::time_point::max()) {
+                    _condition.wait(lock);
+                } else {
+                    _condition.wait_until(lock, wakeup);
+                }
+                --_waiting;
+
+                // the next sleeper recomputes its own tick
+                _sleep_tick = std::numeric_limits<uint64_t>::max();
+            }
+        }
+
+        void pop_ready(std::unique_lock<std::mutex>& lock, T& value) {
+            value = std::move(_ready.front());
+            _ready.pop_front();
+
+            // other sleepers may target a later tick than what is pending now
+            bool wake = _waiting > 0 && (_pending > 0 || !_ready.empty());
+            lock.unlock();
+
+            if (wake) {
+                _condition.notify_one();
+            }
+        }
+
+        const clock::duration _resolution;
+        const clock::time_point _origin;
+        uint64_t _current = 0;                  // the next tick to process
+        uint64_t _sleep_tick = std::numeric_limits<uint64_t>::max();
+        std::size_t _pending = 0;               // elements in the wheel
+        std::size_t _waiting = 0;
+        std::vector<Entry> _wheel[LEVELS][SLOTS];
+        uint64_t _occupied[LEVELS] = {};
+        std::deque<T> _ready;
+        std::mutex _mutex;
+        std::condition_variable _condition;
+};
+
+#endif
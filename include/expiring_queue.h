@@ -0,0 +1,202 @@
+/*******************************************************************************
+ MIT License
+ Copyright (c) 2020 Orhan Kupusoglu
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+*******************************************************************************/
+
+/*!
+ * \anchor ExpiringQueue
+ *
+ * A ConcurrentQueue whose elements carry an expiry time.
+ * Every element gets a deadline of enqueue time + TTL, pops silently skip and
+ * count elements past their deadline, so a consumer that fell behind drops the
+ * stale backlog instead of working through it.
+ * An optional soft limit sheds load on push, either by evicting the oldest
+ * element or by rejecting the newest one.
+ * A zero TTL disables expiry and a zero soft limit disables shedding.
+ * C++11
+ * [std::chrono::steady_clock](https://en.cppreference.com/w/cpp/chrono/steady_clock)
+ */
+
+#ifndef EXPIRING_QUEUE_H
+#define EXPIRING_QUEUE_H
+
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+enum class DropPolicy {
+    drop_oldest,    // evict the head of the queue to make room
+    drop_newest     // reject the element being pushed
+};
+
+template<typename T>
+class ExpiringQueue {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        ExpiringQueue(std::chrono::milliseconds ttl=std::chrono::milliseconds::zero(),
+                      std::size_t soft_limit=0,
+                      DropPolicy policy=DropPolicy::drop_oldest)
+           : _ttl{ttl},
+             _soft_limit{soft_limit},
+             _policy{policy}
+        {}
+        ExpiringQueue(const ExpiringQueue&) = delete;                   // copy constructor
+        ExpiringQueue& operator=(const ExpiringQueue&) = delete;        // copy assignment
+        ExpiringQueue(ExpiringQueue&&) = delete;                        // move constructor
+        ExpiringQueue& operator=(ExpiringQueue &&) = delete;            // move assignment
+
+        void clear() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            std::queue<Entry> blank;
+            std::swap(blank, _queue);
+        }
+
+        // returns false if the element was shed by the drop_newest policy
+        bool push(T const& data) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            clock::time_point now = stamp();
+
+            if (_soft_limit > 0 && _queue.size() >= _soft_limit) {
+                // stale elements are the cheapest to give up
+                purge(now);
+
+                if (_queue.size() >= _soft_limit) {
+                    ++_dropped;
+
+                    if (_policy == DropPolicy::drop_newest) {
+                        return false;
+                    }
+
+                    _queue.pop();
+                }
+            }
+
+            _queue.push({now + _ttl, data});
+            lock.unlock();
+            _condition.notify_one();
+            return true;
+        }
+
+        std::size_t size() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            purge(stamp());
+            return _queue.size();
+        }
+
+        bool empty() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            purge(stamp());
+            return _queue.empty();
+        }
+
+        bool try_pop(T& value) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            purge(stamp());
+
+            if (_queue.empty()) {
+                return false;
+            }
+
+            value = std::move(_queue.front().data);
+            _queue.pop();
+            return true;
+        }
+
+        void wait_and_pop(T& value) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            purge(stamp());
+
+            while (_queue.empty()) {
+                _condition.wait(lock);
+                purge(stamp());
+            }
+
+            value = std::move(_queue.front().data);
+            _queue.pop();
+        }
+
+        bool wait_and_pop_while(T& value,
+            std::chrono::milliseconds timeout_duration=std::chrono::seconds(1),
+            const std::chrono::milliseconds& check_interval=std::chrono::milliseconds(10)) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            purge(stamp());
+
+            while (_queue.empty()) {
+                if (_condition.wait_for(lock, check_interval) == std::cv_status::timeout) {
+                    timeout_duration -= check_interval;
+                    if (timeout_duration <= std::chrono::milliseconds::zero() ) {
+                        return false;
+                    }
+                }
+                purge(stamp());
+            }
+
+            value = std::move(_queue.front().data);
+            _queue.pop();
+            return true;
+        }
+
+        // number of elements skipped because their TTL had passed
+        std::size_t expired() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            return _expired;
+        }
+
+        // number of elements shed because the soft limit was exceeded
+        std::size_t dropped() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            return _dropped;
+        }
+
+    private:
+        struct Entry {
+            clock::time_point deadline;
+            T data;
+        };
+
+        // the clock is only read when expiry is enabled
+        clock::time_point stamp() const {
+            return _ttl > std::chrono::milliseconds::zero() ? clock::now() : clock::time_point{};
+        }
+
+        // deadlines are stamped under the lock, hence they never decrease from head to tail
+        void purge(clock::time_point now) {
+            if (_ttl <= std::chrono::milliseconds::zero()) {
+                return;
+            }
+
+            while (!_queue.empty() && _queue.front().deadline <= now) {
+                _queue.pop();
+                ++_expired;
+            }
+        }
+
+        const std::chrono::milliseconds _ttl;
+        const std::size_t _soft_limit;
+        const DropPolicy _policy;
+        std::size_t _expired = 0;
+        std::size_t _dropped = 0;
+        std::queue<Entry> _queue;
+        std::mutex _mutex;
+        std::condition_variable _condition;
+};
+
+#endif
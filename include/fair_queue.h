@@ -0,0 +1,189 @@
+/*******************************************************************************
+ MIT License
+ Copyright (c) 2020 Orhan Kupusoglu
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+*******************************************************************************/
+
+/*!
+ * \anchor FairQueue
+ *
+ * A multi-tenant concurrent queue: every key gets its own FIFO sub-queue and pops
+ * serve the sub-queues in deficit round-robin order, a tenant with weight w gets
+ * w elements per round.
+ * A noisy tenant can only fill its own sub-queue, the others keep their share.
+ * A sub-queue is reclaimed as soon as it runs empty, weights outlive it.
+ * [Efficient Fair Queuing Using Deficit Round Robin](https://en.wikipedia.org/wiki/Deficit_round_robin)
+ * C++11
+ * [std::unordered_map](https://en.cppreference.com/w/cpp/container/unordered_map)
+ */
+
+#ifndef FAIR_QUEUE_H
+#define FAIR_QUEUE_H
+
+#include <cstdint>
+#include <queue>
+#include <deque>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+template<typename K, typename T, typename Hash = std::hash<K>>
+class FairQueue {
+    public:
+        explicit FairQueue(uint32_t default_weight=1) : _default_weight{default_weight > 0 ? default_weight : 1} {}
+        FairQueue(const FairQueue&) = delete;                           // copy constructor
+        FairQueue& operator=(const FairQueue&) = delete;                // copy assignment
+        FairQueue(FairQueue&&) = delete;                                // move constructor
+        FairQueue& operator=(FairQueue &&) = delete;                    // move assignment
+
+        void clear() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _active.clear();
+            _tenants.clear();
+            _size = 0;
+        }
+
+        // elements served per round, applies from the tenant's next round
+        void set_weight(K const& key, uint32_t weight) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _weights[key] = weight > 0 ? weight : 1;
+        }
+
+        void push(K const& key, T const& data) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            auto it = _tenants.find(key);
+
+            if (it == _tenants.end()) {
+                it = _tenants.emplace(key, Tenant{}).first;
+                it->second.key = &it->first;
+                _active.push_back(&it->second);
+            }
+
+            it->second.queue.push(data);
+            ++_size;
+            lock.unlock();
+            _condition.notify_one();
+        }
+
+        std::size_t size() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            return _size;
+        }
+
+        std::size_t size(K const& key) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            auto it = _tenants.find(key);
+            return it == _tenants.end() ? 0 : it->second.queue.size();
+        }
+
+        // tenants with queued elements
+        std::size_t tenants() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            return _tenants.size();
+        }
+
+        bool empty() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            return _size == 0;
+        }
+
+        bool try_pop(T& value) {
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            if (_size == 0) {
+                return false;
+            }
+
+            serve(value);
+            return true;
+        }
+
+        void wait_and_pop(T& value) {
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            while (_size == 0) {
+                _condition.wait(lock);
+            }
+
+            serve(value);
+        }
+
+        bool wait_and_pop_while(T& value,
+            std::chrono::milliseconds timeout_duration=std::chrono::seconds(1),
+            const std::chrono::milliseconds& check_interval=std::chrono::milliseconds(10)) {
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            while (_size == 0) {
+                if (_condition.wait_for(lock, check_interval) == std::cv_status::timeout) {
+                    timeout_duration -= check_interval;
+                    if (timeout_duration <= std::chrono::milliseconds::zero() ) {
+                        return false;
+                    }
+                }
+            }
+
+            serve(value);
+            return true;
+        }
+
+    private:
+        struct Tenant {
+            const K* key = nullptr;
+            std::queue<T> queue;
+            uint32_t deficit = 0;
+        };
+
+        uint32_t weight(K const& key) const {
+            auto it = _weights.find(key);
+            return it == _weights.end() ? _default_weight : it->second;
+        }
+
+        // every element costs one unit of the deficit
+        void serve(T& value) {
+            Tenant* tenant = _active.front();
+
+            if (tenant->deficit == 0) {
+                tenant->deficit = weight(*tenant->key);
+            }
+
+            value = std::move(tenant->queue.front());
+            tenant->queue.pop();
+            --tenant->deficit;
+            --_size;
+
+            if (tenant->queue.empty()) {
+                K key = *tenant->key;
+                _active.pop_front();
+                _tenants.erase(key);
+            } else if (tenant->deficit == 0) {
+                _active.pop_front();
+                _active.push_back(tenant);
+            }
+        }
+
+        const uint32_t _default_weight;
+        std::size_t _size = 0;
+        std::unordered_map<K, Tenant, Hash> _tenants;       // node based, a Tenant never moves
+        std::unordered_map<K, uint32_t, Hash> _weights;
+        std::deque<Tenant*> _active;                        // round-robin order
+        std::mutex _mutex;
+        std::condition_variable _condition;
+};
+
+#endif
@@ -0,0 +1,353 @@
+/*******************************************************************************
+ MIT License
+ Copyright (c) 2020 Orhan Kupusoglu
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+*******************************************************************************/
+
+/*!
+ * \anchor ObjectPool
+ *
+ * A concurrent pool of reusable objects for payloads that travel between threads.
+ * acquire() hands out a move-only Handle, destroying or resetting the handle
+ * returns the object to the pool, on whichever thread that happens.
+ * Objects come back as they were released: a cleared std::vector or std::string
+ * keeps its capacity, so steady-state message passing makes no heap allocations.
+ *
+ * Every thread keeps a small cache of free objects, full caches spill half of
+ * their objects to a global free list in one step.
+ * The global free list is a lock-free Treiber stack of 32-bit node indexes,
+ * its head carries a 32-bit tag against the ABA problem.
+ * Objects live in chunks that are never freed before the pool, so a node is
+ * always safe to read. Only a new chunk takes a lock.
+ *
+ * Handles must not outlive their pool. Thread caches refer to their pool through
+ * a std::weak_ptr, so destroying the pool frees its objects at once: a cache of
+ * a destroyed pool keeps only its list of indexes, until the thread exits or uses
+ * a pool of the same type again.
+ * [Treiber stack](https://en.wikipedia.org/wiki/Treiber_stack)
+ * C++11
+ * [std::atomic](https://en.cppreference.com/w/cpp/atomic/atomic)
+ * [thread_local](https://en.cppreference.com/w/cpp/language/storage_duration)
+ */
+
+#ifndef OBJECT_POOL_H
+#define OBJECT_POOL_H
+
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <new>
+#include <utility>
+#include <atomic>
+#include <mutex>
+
+template<typename T>
+class ObjectPool {
+    private:
+        struct Core;
+
+    public:
+        class Handle {
+            public:
+                Handle() = default;                                     // default constructor
+                Handle(const Handle&) = delete;                         // copy constructor
+                Handle& operator=(const Handle&) = delete;              // copy assignment
+
+                Handle(Handle&& other) noexcept                         // move constructor
+                   : _core{other._core},
+                     _index{other._index},
+                     _object{other._object} {
+                    other._object = nullptr;
+                }
+
+                Handle& operator=(Handle&& other) noexcept {            // move assignment
+                    if (this != &other) {
+                        reset();
+                        _core = other._core;
+                        _index = other._index;
+                        _object = other._object;
+                        other._object = nullptr;
+                    }
+                    return *this;
+                }
+
+                ~Handle() {
+                    reset();
+                }
+
+                // returns the object to the pool
+                void reset() {
+                    if (_object != nullptr) {
+                        _core->release(_index);
+                        _object = nullptr;
+                    }
+                }
+
+                T* get() const {
+                    return _object;
+                }
+
+                T& operator*() const {
+                    return *_object;
+                }
+
+                T* operator->() const {
+                    return _object;
+                }
+
+                explicit operator bool() const {
+                    return _object != nullptr;
+                }
+
+            private:
+                friend class ObjectPool;
+
+                Handle(Core* core, uint32_t index, T* object) : _core{core}, _index{index}, _object{object} {}
+
+                Core* _core = nullptr;
+                uint32_t _index = 0;
+                T* _object = nullptr;
+        };
+
+        // chunk_size is rounded up to a power of two, at most 2^19
+        explicit ObjectPool(std::size_t chunk_size=64) : _core{std::make_shared<Core>(chunk_size)} {}
+        ObjectPool(const ObjectPool&) = delete;                         // copy constructor
+        ObjectPool& operator=(const ObjectPool&) = delete;              // copy assignment
+        ObjectPool(ObjectPool&&) = delete;                              // move constructor
+        ObjectPool& operator=(ObjectPool &&) = delete;                  // move assignment
+
+        // throws std::bad_alloc beyond MAX_CHUNKS chunks
+        Handle acquire() {
+            uint32_t index = _core->acquire();
+            return Handle{_core.get(), index, &_core->node(index).object};
+        }
+
+        // objects created so far, in use or free
+        std::size_t capacity() const {
+            return _core->chunk_count.load() << _core->shift;
+        }
+
+        // chunk allocations so far, constant in the steady state
+        std::size_t allocations() const {
+            return _core->chunk_count.load();
+        }
+
+        static const std::size_t MAX_CHUNKS = 4096;
+        static const std::size_t CACHE_SIZE = 32;
+
+    private:
+        struct Node {
+            T object{};
+            std::atomic<uint32_t> next{0};                  // index + 1 of the next free node, 0 ends the list
+        };
+
+        struct Cache;
+
+        struct Core : std::enable_shared_from_this<Core> {
+            explicit Core(std::size_t chunk_size) {
+                // every index + 1 of MAX_CHUNKS chunks fits in 32 bits
+                while (shift < 19 && (std::size_t{1} << shift) < chunk_size) {
+                    ++shift;
+                }
+                mask = (uint32_t{1} << shift) - 1;
+
+                for (auto& chunk : chunks) {
+                    chunk = nullptr;
+                }
+            }
+
+            ~Core() {
+                for (std::size_t c = 0; c < chunk_count; ++c) {
+                    delete[] chunks[c].load();
+                }
+            }
+
+            Node& node(uint32_t index) {
+                return chunks[index >> shift].load(std::memory_order_acquire)[index & mask];
+            }
+
+            uint32_t acquire() {
+                Cache& cache = local();
+
+                if (cache.free.empty()) {
+                    uint32_t index = 0;
+                    if (pop(index)) {
+                        return index;
+                    }
+                    return grow(cache);
+                }
+
+                uint32_t index = cache.free.back();
+                cache.free.pop_back();
+                return index;
+            }
+
+            void release(uint32_t index) {
+                Cache& cache = local();
+
+                if (cache.free.size() == CACHE_SIZE) {
+                    spill(cache, CACHE_SIZE / 2);
+                }
+
+                cache.free.push_back(index);
+            }
+
+            // moves the newest n indexes of a cache to the global list in a single CAS
+            void spill(Cache& cache, std::size_t n) {
+                if (n == 0) {
+                    return;
+                }
+
+                std::size_t first = cache.free.size() - n;
+
+                for (std::size_t i = first; i + 1 < cache.free.size(); ++i) {
+                    node(cache.free[i]).next.store(cache.free[i + 1] + 1, std::memory_order_relaxed);
+                }
+
+                push(cache.free[first], cache.free.back());
+                cache.free.resize(first);
+            }
+
+            // links the chain head ... tail in front of the global list
+            void push(uint32_t head, uint32_t tail) {
+                uint64_t old_top = top.load(std::memory_order_relaxed);
+                uint64_t new_top;
+
+                do {
+                    node(tail).next.store(static_cast<uint32_t>(old_top), std::memory_order_relaxed);
+                    new_top = ((old_top >> 32) + 1) << 32 | (head + 1);
+                } while (!top.compare_exchange_weak(old_top, new_top, std::memory_order_release, std::memory_order_relaxed));
+            }
+
+            bool pop(uint32_t& index) {
+                uint64_t old_top = top.load(std::memory_order_acquire);
+                uint64_t new_top;
+
+                do {
+                    uint32_t first = static_cast<uint32_t>(old_top);
+                    if (first == 0) {
+                        return false;
+                    }
+
+                    // the node may be popped and pushed meanwhile, the tag then fails the CAS
+                    uint32_t next = node(first - 1).next.load(std::memory_order_relaxed);
+                    new_top = ((old_top >> 32) + 1) << 32 | next;
+                } while (!top.compare_exchange_weak(old_top, new_top, std::memory_order_acquire, std::memory_order_acquire));
+
+                index = static_cast<uint32_t>(old_top) - 1;
+                return true;
+            }
+
+            // a new chunk fills the cache, the first node is handed out
+            uint32_t grow(Cache& cache) {
+                std::unique_lock<std::mutex> lock(grow_mutex);
+                std::size_t c = chunk_count.load();
+
+                if (c == MAX_CHUNKS) {
+                    throw std::bad_alloc{};
+                }
+
+                chunks[c].store(new Node[std::size_t{1} << shift], std::memory_order_release);
+                chunk_count.store(c + 1);
+                lock.unlock();
+
+                uint32_t base = static_cast<uint32_t>(c << shift);
+                uint32_t last = base + mask;
+
+                for (uint32_t i = last; i > base; --i) {
+                    cache.free.push_back(i);
+                }
+
+                if (cache.free.size() > CACHE_SIZE) {
+                    spill(cache, cache.free.size() - CACHE_SIZE);
+                }
+
+                return base;
+            }
+
+            // the calling thread's cache of this core
+            Cache& local() {
+                static thread_local Caches caches;
+
+                // an expired core may have left its address to this one
+                if (caches.last != nullptr && caches.last->owner == this && !caches.last->core.expired()) {
+                    return *caches.last;
+                }
+
+                Cache* found = nullptr;
+                for (auto it = caches.list.begin(); it != caches.list.end(); ) {
+                    if ((*it)->core.expired()) {
+                        it = caches.list.erase(it);
+                    } else {
+                        if ((*it)->owner == this) {
+                            found = it->get();
+                        }
+                        ++it;
+                    }
+                }
+
+                if (found == nullptr) {
+                    caches.list.emplace_back(new Cache{this->shared_from_this()});
+                    found = caches.list.back().get();
+                }
+
+                caches.last = found;
+                return *found;
+            }
+
+            uint32_t shift = 0;
+            uint32_t mask = 0;
+            std::atomic<Node*> chunks[MAX_CHUNKS];
+            std::atomic<std::size_t> chunk_count{0};
+            std::mutex grow_mutex;
+            std::atomic<uint64_t> top{0};                   // tag << 32 | index + 1 of the first free node
+        };
+
+        struct Cache {
+            explicit Cache(const std::shared_ptr<Core>& c) : core{c}, owner{c.get()} {
+                free.reserve(CACHE_SIZE + 1);
+            }
+
+            // a live pool gets the cached objects back, held alive for the spill
+            ~Cache() {
+                std::shared_ptr<Core> live = core.lock();
+
+                if (live) {
+                    live->spill(*this, free.size());
+                }
+            }
+
+            std::weak_ptr<Core> core;                   // does not keep the pool's chunks
+            Core* owner;                                // identity only, may dangle once core expired
+            std::vector<uint32_t> free;
+        };
+
+        struct Caches {
+            std::vector<std::unique_ptr<Cache>> list;
+            Cache* last = nullptr;
+        };
+
+        std::shared_ptr<Core> _core;
+};
+
+template<typename T>
+const std::size_t ObjectPool<T>::MAX_CHUNKS;
+
+template<typename T>
+const std::size_t ObjectPool<T>::CACHE_SIZE;
+
+#endif
@@ -0,0 +1,261 @@
+/*******************************************************************************
+ MIT License
+ Copyright (c) 2020 Orhan Kupusoglu
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+*******************************************************************************/
+
+/*!
+ * \anchor PartitionedQueue
+ *
+ * Key affinity for several stateful consumers: push(key, value) hashes the key
+ * to one of a fixed number of partitions, each a ConcurrentQueue, and every
+ * consumer pops from its own partition only.
+ * All elements of a key go to the same partition in push order, so a consumer
+ * can keep the state of its keys without sharing it.
+ *
+ * Keys hash to virtual buckets, buckets map to partitions through a table.
+ * rebalance() moves buckets from the busiest to the idlest partition by the
+ * pushes counted since the last rebalance, the hook hears about every move.
+ * Elements of a moved bucket that are still queued stay in the old partition:
+ * rebalance while producers are paused and the partitions are drained, or let
+ * the hook hand the keys' state over.
+ * C++11
+ * [std::atomic](https://en.cppreference.com/w/cpp/atomic/atomic)
+ */
+
+#ifndef PARTITIONED_QUEUE_H
+#define PARTITIONED_QUEUE_H
+
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <string>
+#include <stdexcept>
+
+#include "concurrent_queue.h"
+
+struct PartitionStats {
+    std::size_t depth;                                  // queued now
+    uint64_t pushed;                                    // since construction
+    std::size_t buckets;                                // virtual buckets mapped to it
+};
+
+template<typename K, typename T, typename Hash = std::hash<K>, typename Storage = std::queue<T>>
+class PartitionedQueue {
+    public:
+        using Partition = ConcurrentQueue<T, Storage>;
+        // hook(bucket, from, to), called before the bucket moves
+        using Hook = std::function<void(std::size_t, std::size_t, std::size_t)>;
+
+        // buckets_per_partition sets the granularity of rebalancing
+        explicit PartitionedQueue(std::size_t partitions, std::size_t buckets_per_partition=64)
+           : _buckets{(partitions > 0 ? partitions : 1) * (buckets_per_partition > 0 ? buckets_per_partition : 1)},
+             _table(_buckets),
+             _load(_buckets),
+             _pushed(partitions > 0 ? partitions : 1)
+        {
+            std::size_t n = partitions > 0 ? partitions : 1;
+
+            for (std::size_t p = 0; p < n; ++p) {
+                _partitions.push_back(std::unique_ptr<Partition>{new Partition{}});
+            }
+
+            // round-robin start
+            for (std::size_t b = 0; b < _buckets; ++b) {
+                _table[b] = static_cast<uint32_t>(b % n);
+                _load[b] = 0;
+            }
+
+            for (auto& pushed : _pushed) {
+                pushed = 0;
+            }
+        }
+
+        PartitionedQueue(const PartitionedQueue&) = delete;             // copy constructor
+        PartitionedQueue& operator=(const PartitionedQueue&) = delete;  // copy assignment
+        PartitionedQueue(PartitionedQueue&&) = delete;                  // move constructor
+        PartitionedQueue& operator=(PartitionedQueue &&) = delete;      // move assignment
+
+        void clear() {
+            for (auto& partition : _partitions) {
+                partition->clear();
+            }
+        }
+
+        std::size_t partitions() const {
+            return _partitions.size();
+        }
+
+        std::size_t bucket_of(K const& key) const {
+            return _hash(key) % _buckets;
+        }
+
+        std::size_t partition_of(K const& key) const {
+            return _table[bucket_of(key)].load(std::memory_order_acquire);
+        }
+
+        void push(K const& key, T const& data) {
+            std::size_t bucket = bucket_of(key);
+            std::size_t p = _table[bucket].load(std::memory_order_acquire);
+
+            _load[bucket].fetch_add(1, std::memory_order_relaxed);
+            _pushed[p].fetch_add(1, std::memory_order_relaxed);
+            _partitions[p]->push(data);
+        }
+
+        // the consumer's own queue
+        Partition& partition(std::size_t p) {
+            return *_partitions[p];
+        }
+
+        bool try_pop(std::size_t p, T& value) {
+            return _partitions[p]->try_pop(value);
+        }
+
+        void wait_and_pop(std::size_t p, T& value) {
+            _partitions[p]->wait_and_pop(value);
+        }
+
+        bool wait_and_pop_while(std::size_t p, T& value,
+            std::chrono::milliseconds timeout_duration=std::chrono::seconds(1),
+            const std::chrono::milliseconds& check_interval=std::chrono::milliseconds(10)) {
+            return _partitions[p]->wait_and_pop_while(value, timeout_duration, check_interval);
+        }
+
+        std::size_t size() {
+            std::size_t n = 0;
+
+            for (auto& partition : _partitions) {
+                n += partition->size();
+            }
+
+            return n;
+        }
+
+        bool empty() {
+            return size() == 0;
+        }
+
+        PartitionStats stats(std::size_t p) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            std::size_t buckets = 0;
+
+            for (std::size_t b = 0; b < _buckets; ++b) {
+                if (_table[b] == p) {
+                    ++buckets;
+                }
+            }
+
+            return PartitionStats{_partitions[p]->size(), _pushed[p].load(), buckets};
+        }
+
+        void set_rebalance_hook(Hook hook) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _hook = hook;
+        }
+
+        // moves a single bucket, for a placement of the caller's own
+        // throws std::out_of_range for a bucket or a partition that does not exist
+        void move_bucket(std::size_t bucket, std::size_t to) {
+            if (bucket >= _buckets || to >= _partitions.size()) {
+                throw std::out_of_range("no such bucket or partition: " + std::to_string(bucket) + " -> " + std::to_string(to));
+            }
+
+            std::unique_lock<std::mutex> lock(_mutex);
+            move(bucket, to);
+        }
+
+        // evens out the pushes since the last rebalance, returns the number of moved buckets
+        std::size_t rebalance() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            std::vector<uint64_t> bucket_load(_buckets);
+            std::vector<uint64_t> load(_partitions.size(), 0);
+
+            for (std::size_t b = 0; b < _buckets; ++b) {
+                bucket_load[b] = _load[b].exchange(0, std::memory_order_relaxed);
+                load[_table[b]] += bucket_load[b];
+            }
+
+            std::size_t moved = 0;
+
+            // a bucket moves only if it narrows the gap between the busiest and the idlest partition
+            for (std::size_t round = 0; round < _buckets; ++round) {
+                std::size_t busy = 0;
+                std::size_t idle = 0;
+
+                for (std::size_t p = 1; p < load.size(); ++p) {
+                    if (load[p] > load[busy]) {
+                        busy = p;
+                    }
+                    if (load[p] < load[idle]) {
+                        idle = p;
+                    }
+                }
+
+                uint64_t gap = load[busy] - load[idle];
+                std::size_t best = _buckets;
+
+                for (std::size_t b = 0; b < _buckets; ++b) {
+                    if (_table[b] == busy && bucket_load[b] > 0 && bucket_load[b] < gap
+                        && (best == _buckets || bucket_load[b] > bucket_load[best])) {
+                        best = b;
+                    }
+                }
+
+                if (best == _buckets) {
+                    break;
+                }
+
+                move(best, idle);
+                load[busy] -= bucket_load[best];
+                load[idle] += bucket_load[best];
+                ++moved;
+            }
+
+            return moved;
+        }
+
+    private:
+        void move(std::size_t bucket, std::size_t to) {
+            std::size_t from = _table[bucket];
+
+            if (from == to) {
+                return;
+            }
+
+            if (_hook) {
+                _hook(bucket, from, to);
+            }
+
+            _table[bucket].store(static_cast<uint32_t>(to), std::memory_order_release);
+        }
+
+        const std::size_t _buckets;
+        Hash _hash{};
+        std::vector<std::atomic<uint32_t>> _table;         // bucket -> partition
+        std::vector<std::atomic<uint64_t>> _load;          // pushes per bucket since the last rebalance
+        std::vector<std::atomic<uint64_t>> _pushed;        // pushes per partition
+        std::vector<std::unique_ptr<Partition>> _partitions;
+        std::mutex _mutex;                                  // serializes table changes
+        Hook _hook;
+};
+
+#endif
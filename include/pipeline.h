@@ -0,0 +1,521 @@
+/*******************************************************************************
+ MIT License
+ Copyright (c) 2020 Orhan Kupusoglu
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+*******************************************************************************/
+
+/*!
+ * \anchor Pipeline
+ *
+ * A small multi-stage pipeline built on ConcurrentQueue.
+ * Stages are declared as a source, any number of transforms and a sink, each with
+ * its own thread count, and are connected by channels whose queue type and
+ * capacity are chosen per stage.
+ * When the last thread of a stage finishes, its output channel sends one
+ * end-of-stream marker per downstream thread, so the end of the stream travels
+ * through the whole pipeline and every thread returns on its own.
+ * A channel keyed with key_by() sends an element to the consumer thread
+ * key(element) % threads, so a thread can own the state of its keys.
+ * Every stage counts the elements it handled, stats() reports the throughput.
+ * The stages of one pipeline run once, declare a new pipeline for another run.
+ *
+ * Pipeline pipeline;
+ * auto& numbers = pipeline.source<int>("count", 1, [](std::size_t, PipelineEmitter<int>& emit) { ... });
+ * auto& squares = pipeline.transform<int, int>("square", 4, numbers, [](const int& x, PipelineEmitter<int>& emit) { emit(x * x); });
+ * pipeline.sink<int>("print", 1, squares, [](const int& x) { std::cout << x << '\n'; });
+ * pipeline.run();
+ *
+ * C++11
+ * [std::function](https://en.cppreference.com/w/cpp/utility/functional/function)
+ */
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <stdexcept>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+#include "concurrent_queue.h"
+
+// the default queue of a channel, any queue with push() and wait_and_pop() fits
+template<typename M>
+using PipelineQueue = ConcurrentQueue<M>;
+
+struct PipelineStats {
+    std::string name;
+    std::size_t threads;
+    uint64_t items;
+    std::chrono::steady_clock::duration elapsed;
+
+    // items per second
+    double throughput() const {
+        double seconds = std::chrono::duration_cast<std::chrono::duration<double>>(elapsed).count();
+        return seconds > 0.0 ? items / seconds : 0.0;
+    }
+};
+
+class PipelineChannelBase {
+    public:
+        virtual ~PipelineChannelBase() {}
+
+        void attach_producers(std::size_t n) {
+            _producers += n;
+        }
+
+        void attach_consumers(std::size_t n) {
+            _consumers += n;
+        }
+
+        std::size_t consumers() const {
+            return _consumers;
+        }
+
+        // called by Pipeline::run() once the stages are declared
+        virtual void prepare() {}
+
+    protected:
+        std::atomic<std::size_t> _producers{0};
+        std::size_t _consumers = 0;
+};
+
+template<typename T>
+class PipelineChannel : public PipelineChannelBase {
+    public:
+        using Key = std::function<std::size_t(T const&)>;
+
+        explicit PipelineChannel(std::size_t capacity) : _capacity{capacity} {}
+
+        // every element goes to the consumer thread key(element) % threads, a thread then owns the state of its keys,
+        // call before Pipeline::run()
+        void key_by(Key key) {
+            _key = key;
+        }
+
+        // blocks while capacity elements are in flight, zero capacity is unbounded
+        void push(T const& data) {
+            if (_capacity > 0) {
+                std::unique_lock<std::mutex> lock(_mutex);
+
+                while (_in_flight >= _capacity) {
+                    _space.wait(lock);
+                }
+
+                ++_in_flight;
+            }
+
+            enqueue(&data);
+        }
+
+        // false at the end of the stream
+        bool pop(T& value) {
+            return pop(0, value);
+        }
+
+        // consumer is the thread index in its stage, it picks the queue of a keyed channel
+        bool pop(std::size_t consumer, T& value) {
+            if (!dequeue(consumer, value)) {
+                return false;
+            }
+
+            if (_capacity > 0) {
+                std::unique_lock<std::mutex> lock(_mutex);
+                --_in_flight;
+                lock.unlock();
+                _space.notify_one();
+            }
+
+            return true;
+        }
+
+        // the last producer thread ends the stream for every consumer thread
+        void producer_done() {
+            if (--_producers == 0) {
+                for (std::size_t i = 0; i < _consumers; ++i) {
+                    enqueue(nullptr);
+                }
+            }
+        }
+
+    protected:
+        // nullptr is the end-of-stream marker
+        virtual void enqueue(T const* data) = 0;
+        virtual bool dequeue(std::size_t consumer, T& value) = 0;
+
+        Key _key;
+
+    private:
+        const std::size_t _capacity;
+        std::size_t _in_flight = 0;
+        std::mutex _mutex;
+        std::condition_variable _space;
+};
+
+template<typename T, template<typename> class Queue = PipelineQueue>
+class PipelineQueueChannel : public PipelineChannel<T> {
+    public:
+        explicit PipelineQueueChannel(std::size_t capacity) : PipelineChannel<T>(capacity) {
+            _queues.emplace_back(new Queue<Message>{});
+        }
+
+        // a keyed channel has a queue per consumer thread
+        void prepare() override {
+            std::size_t n = this->_key ? this->consumers() : 1;
+
+            while (_queues.size() < n) {
+                _queues.emplace_back(new Queue<Message>{});
+            }
+        }
+
+    protected:
+        void enqueue(T const* data) override {
+            Message message{};
+            std::size_t q = 0;
+
+            if (data == nullptr) {
+                message.end = true;
+                // one end-of-stream marker per queue
+                if (_queues.size() > 1) {
+                    q = _ends++ % _queues.size();
+                }
+            } else {
+                message.data = *data;
+                if (_queues.size() > 1) {
+                    q = this->_key(*data) % _queues.size();
+                }
+            }
+
+            _queues[q]->push(std::move(message));
+        }
+
+        bool dequeue(std::size_t consumer, T& value) override {
+            Queue<Message>& queue = *_queues[_queues.size() > 1 ? consumer : 0];
+            Message message{};
+            queue.wait_and_pop(message);
+
+            if (message.end) {
+                return false;
+            }
+
+            value = std::move(message.data);
+            return true;
+        }
+
+    private:
+        struct Message {
+            bool end;
+            T data;
+        };
+
+        std::vector<std::unique_ptr<Queue<Message>>> _queues;
+        std::atomic<std::size_t> _ends{0};
+};
+
+template<typename T>
+class PipelineEmitter {
+    public:
+        explicit PipelineEmitter(PipelineChannel<T>& channel) : _channel(channel) {}
+
+        void operator()(T const& data) {
+            _channel.push(data);
+            ++_count;
+        }
+
+        uint64_t count() const {
+            return _count;
+        }
+
+    private:
+        PipelineChannel<T>& _channel;
+        uint64_t _count = 0;
+};
+
+class PipelineStage {
+    public:
+        PipelineStage(const std::string& name, std::size_t threads)
+           : _name{name},
+             _threads{threads > 0 ? threads : 1}
+        {}
+
+        virtual ~PipelineStage() {}
+
+        void start() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _t_start = std::chrono::steady_clock::now();
+            _running = _threads;
+            lock.unlock();
+
+            for (std::size_t i = 0; i < _threads; ++i) {
+                _workers.push_back(std::thread{&PipelineStage::work_thread, this, i});
+            }
+        }
+
+        void join() {
+            for (auto& worker : _workers) {
+                worker.join();
+            }
+
+            _workers.clear();
+        }
+
+        // the times are guarded by the stage's mutex, stats() may run on any thread
+        PipelineStats stats() const {
+            std::unique_lock<std::mutex> lock(_mutex);
+            auto t_end = _running > 0 ? std::chrono::steady_clock::now() : _t_end;
+            return PipelineStats{_name, _threads, _items.load(), t_end - _t_start};
+        }
+
+        std::size_t threads() const {
+            return _threads;
+        }
+
+    protected:
+        // one thread's share of the stage
+        virtual void work(std::size_t index) = 0;
+
+        void count(uint64_t n) {
+            _items.fetch_add(n, std::memory_order_relaxed);
+        }
+
+        // counters are published in batches to keep the stage threads off a shared cache line
+        static const uint64_t COUNT_BATCH = 1024;
+
+    private:
+        void work_thread(std::size_t index) {
+            work(index);
+
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (--_running == 0) {
+                _t_end = std::chrono::steady_clock::now();
+            }
+        }
+
+        const std::string _name;
+        const std::size_t _threads;
+        std::vector<std::thread> _workers;
+        std::atomic<uint64_t> _items{0};
+        std::size_t _running = 0;
+        std::chrono::steady_clock::time_point _t_start;
+        std::chrono::steady_clock::time_point _t_end;
+        mutable std::mutex _mutex;                          // guards _running and the times
+};
+
+template<typename Out>
+class PipelineSource : public PipelineStage {
+    public:
+        using Body = std::function<void(std::size_t, PipelineEmitter<Out>&)>;
+
+        PipelineSource(const std::string& name, std::size_t threads, PipelineChannel<Out>& output, Body body)
+           : PipelineStage(name, threads),
+             _output(output),
+             _body{body}
+        {}
+
+    protected:
+        void work(std::size_t index) override {
+            PipelineEmitter<Out> emit{_output};
+            _body(index, emit);
+            count(emit.count());
+            _output.producer_done();
+        }
+
+    private:
+        PipelineChannel<Out>& _output;
+        Body _body;
+};
+
+template<typename In, typename Out>
+class PipelineTransform : public PipelineStage {
+    public:
+        using Body = std::function<void(In const&, PipelineEmitter<Out>&)>;
+        using Flush = std::function<void(std::size_t, PipelineEmitter<Out>&)>;
+
+        PipelineTransform(const std::string& name, std::size_t threads,
+                          PipelineChannel<In>& input, PipelineChannel<Out>& output, Body body, Flush flush)
+           : PipelineStage(name, threads),
+             _input(input),
+             _output(output),
+             _body{body},
+             _flush{flush}
+        {}
+
+    protected:
+        void work(std::size_t index) override {
+            PipelineEmitter<Out> emit{_output};
+            In item{};
+            uint64_t n = 0;
+
+            while (_input.pop(index, item)) {
+                _body(item, emit);
+                if (++n == COUNT_BATCH) {
+                    count(n);
+                    n = 0;
+                }
+            }
+
+            count(n);
+
+            // stateful stages emit what they held back
+            if (_flush) {
+                _flush(index, emit);
+            }
+
+            _output.producer_done();
+        }
+
+    private:
+        PipelineChannel<In>& _input;
+        PipelineChannel<Out>& _output;
+        Body _body;
+        Flush _flush;
+};
+
+template<typename In>
+class PipelineSink : public PipelineStage {
+    public:
+        using Body = std::function<void(In const&)>;
+        using Finish = std::function<void(std::size_t)>;
+
+        PipelineSink(const std::string& name, std::size_t threads, PipelineChannel<In>& input, Body body, Finish finish)
+           : PipelineStage(name, threads),
+             _input(input),
+             _body{body},
+             _finish{finish}
+        {}
+
+    protected:
+        void work(std::size_t index) override {
+            In item{};
+            uint64_t n = 0;
+
+            while (_input.pop(index, item)) {
+                _body(item);
+                if (++n == COUNT_BATCH) {
+                    count(n);
+                    n = 0;
+                }
+            }
+
+            count(n);
+
+            if (_finish) {
+                _finish(index);
+            }
+        }
+
+    private:
+        PipelineChannel<In>& _input;
+        Body _body;
+        Finish _finish;
+};
+
+class Pipeline {
+    public:
+        Pipeline() = default;                                           // default constructor
+        Pipeline(const Pipeline&) = delete;                             // copy constructor
+        Pipeline& operator=(const Pipeline&) = delete;                  // copy assignment
+        Pipeline(Pipeline&&) = delete;                                  // move constructor
+        Pipeline& operator=(Pipeline &&) = delete;                      // move assignment
+
+        // body(thread index, emit) produces the stream
+        template<typename Out, template<typename> class Queue = PipelineQueue>
+        PipelineChannel<Out>& source(const std::string& name, std::size_t threads,
+                                     typename PipelineSource<Out>::Body body,
+                                     std::size_t capacity=0) {
+            PipelineChannel<Out>& output = channel<Out, Queue>(capacity);
+            std::unique_ptr<PipelineStage> stage{new PipelineSource<Out>(name, threads, output, body)};
+            output.attach_producers(stage->threads());
+            _stages.push_back(std::move(stage));
+            return output;
+        }
+
+        // body(item, emit) runs for every element, flush(thread index, emit) at the end of the stream
+        template<typename In, typename Out, template<typename> class Queue = PipelineQueue>
+        PipelineChannel<Out>& transform(const std::string& name, std::size_t threads,
+                                        PipelineChannel<In>& input,
+                                        typename PipelineTransform<In, Out>::Body body,
+                                        typename PipelineTransform<In, Out>::Flush flush=nullptr,
+                                        std::size_t capacity=0) {
+            PipelineChannel<Out>& output = channel<Out, Queue>(capacity);
+            std::unique_ptr<PipelineStage> stage{new PipelineTransform<In, Out>(name, threads, input, output, body, flush)};
+            input.attach_consumers(stage->threads());
+            output.attach_producers(stage->threads());
+            _stages.push_back(std::move(stage));
+            return output;
+        }
+
+        // body(item) runs for every element, finish(thread index) at the end of the stream
+        template<typename In>
+        void sink(const std::string& name, std::size_t threads,
+                  PipelineChannel<In>& input,
+                  typename PipelineSink<In>::Body body,
+                  typename PipelineSink<In>::Finish finish=nullptr) {
+            std::unique_ptr<PipelineStage> stage{new PipelineSink<In>(name, threads, input, body, finish)};
+            input.attach_consumers(stage->threads());
+            _stages.push_back(std::move(stage));
+        }
+
+        // blocks until the end of the stream has passed the last stage
+        void run() {
+            for (auto& ch : _channels) {
+                if (ch->consumers() == 0) {
+                    throw std::logic_error("pipeline channel without a consumer stage");
+                }
+                ch->prepare();
+            }
+
+            for (auto& stage : _stages) {
+                stage->start();
+            }
+
+            for (auto& stage : _stages) {
+                stage->join();
+            }
+        }
+
+        // in declaration order, safe to call while running
+        std::vector<PipelineStats> stats() const {
+            std::vector<PipelineStats> all;
+
+            for (auto& stage : _stages) {
+                all.push_back(stage->stats());
+            }
+
+            return all;
+        }
+
+    private:
+        template<typename T, template<typename> class Queue>
+        PipelineChannel<T>& channel(std::size_t capacity) {
+            PipelineChannel<T>* ch = new PipelineQueueChannel<T, Queue>(capacity);
+            _channels.push_back(std::unique_ptr<PipelineChannelBase>{ch});
+            return *ch;
+        }
+
+        std::vector<std::unique_ptr<PipelineChannelBase>> _channels;
+        std::vector<std::unique_ptr<PipelineStage>> _stages;
+};
+
+#endif
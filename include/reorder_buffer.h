@@ -0,0 +1,178 @@
+/*******************************************************************************
+ MIT License
+ Copyright (c) 2020 Orhan Kupusoglu
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+*******************************************************************************/
+
+/*!
+ * \anchor ReorderBuffer
+ *
+ * Restores sequence order after an out-of-order parallel stage.
+ * The source stamps every element with a sequence number, for example with
+ * next_sequence(), any number of workers push their results as they complete
+ * and pops release them strictly in sequence order.
+ * The buffer is a bounded window of slots: a worker that runs ahead of the
+ * oldest missing result by a full window blocks until the window moves on.
+ * Sequence numbers must be unique and contiguous from zero.
+ * C++11
+ * [std::condition_variable](https://en.cppreference.com/w/cpp/thread/condition_variable)
+ */
+
+#ifndef REORDER_BUFFER_H
+#define REORDER_BUFFER_H
+
+#include <cstdint>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+template<typename T>
+class ReorderBuffer {
+    public:
+        explicit ReorderBuffer(std::size_t window=1024)
+           : _window{window > 0 ? window : 1},
+             _slots(_window),
+             _filled(_window, 0)
+        {}
+        ReorderBuffer(const ReorderBuffer&) = delete;                   // copy constructor
+        ReorderBuffer& operator=(const ReorderBuffer&) = delete;        // copy assignment
+        ReorderBuffer(ReorderBuffer&&) = delete;                        // move constructor
+        ReorderBuffer& operator=(ReorderBuffer &&) = delete;            // move assignment
+
+        // stamps for the source, independent of the buffer's lock
+        uint64_t next_sequence() {
+            return _sequence++;
+        }
+
+        // blocks while seq is a full window ahead, false for a released or duplicate seq
+        bool push(uint64_t seq, T const& data) {
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            while (seq >= _next + _window) {
+                _space.wait(lock);
+            }
+
+            std::size_t slot = seq % _window;
+
+            if (seq < _next || _filled[slot]) {
+                return false;
+            }
+
+            _slots[slot] = data;
+            _filled[slot] = 1;
+            ++_size;
+
+            bool head = seq == _next;
+            lock.unlock();
+
+            if (head) {
+                _ready.notify_one();
+            }
+
+            return true;
+        }
+
+        // results waiting for an earlier one included
+        std::size_t size() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            return _size;
+        }
+
+        bool empty() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            return _size == 0;
+        }
+
+        // the sequence number the next pop releases
+        uint64_t next() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            return _next;
+        }
+
+        bool try_pop(T& value) {
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            if (!_filled[_next % _window]) {
+                return false;
+            }
+
+            release(lock, value);
+            return true;
+        }
+
+        void wait_and_pop(T& value) {
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            while (!_filled[_next % _window]) {
+                _ready.wait(lock);
+            }
+
+            release(lock, value);
+        }
+
+        bool wait_and_pop_while(T& value,
+            std::chrono::milliseconds timeout_duration=std::chrono::seconds(1),
+            const std::chrono::milliseconds& check_interval=std::chrono::milliseconds(10)) {
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            while (!_filled[_next % _window]) {
+                if (_ready.wait_for(lock, check_interval) == std::cv_status::timeout) {
+                    timeout_duration -= check_interval;
+                    if (timeout_duration <= std::chrono::milliseconds::zero() ) {
+                        return false;
+                    }
+                }
+            }
+
+            release(lock, value);
+            return true;
+        }
+
+    private:
+        void release(std::unique_lock<std::mutex>& lock, T& value) {
+            std::size_t slot = _next % _window;
+
+            value = std::move(_slots[slot]);
+            _filled[slot] = 0;
+            --_size;
+            ++_next;
+
+            // the next element may already be there for another consumer
+            bool more = _filled[_next % _window] != 0;
+            lock.unlock();
+
+            _space.notify_all();
+            if (more) {
+                _ready.notify_one();
+            }
+        }
+
+        const std::size_t _window;
+        std::vector<T> _slots;
+        std::vector<char> _filled;
+        uint64_t _next = 0;
+        std::size_t _size = 0;
+        std::atomic<uint64_t> _sequence{0};
+        std::mutex _mutex;
+        std::condition_variable _ready;
+        std::condition_variable _space;
+};
+
+#endif
@@ -0,0 +1,183 @@
+/*******************************************************************************
+ MIT License
+ Copyright (c) 2020 Orhan Kupusoglu
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+*******************************************************************************/
+
+/*!
+ * \anchor RingBuffer
+ *
+ * An unbounded FIFO in one contiguous power-of-two array, a storage backend for
+ * ConcurrentQueue in place of std::queue over std::deque:
+ *
+ * ConcurrentQueue<std::tuple<uint32_t, uint32_t, uint32_t>, RingBuffer<std::tuple<uint32_t, uint32_t, uint32_t>>> queue;
+ *
+ * A full ring doubles, an empty one keeps its array: the capacity is the
+ * high-water mark rounded up to a power of two, after that pushes never allocate.
+ * Neighbouring elements share cache lines, so draining a batch is a linear scan.
+ * Not thread-safe on its own, like std::queue.
+ * C++11
+ * [std::allocator](https://en.cppreference.com/w/cpp/memory/allocator)
+ */
+
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+template<typename T>
+class RingBuffer {
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using reference = T&;
+        using const_reference = T const&;
+
+        RingBuffer() = default;                                         // default constructor
+        RingBuffer(const RingBuffer&) = delete;                         // copy constructor
+        RingBuffer& operator=(const RingBuffer&) = delete;              // copy assignment
+
+        RingBuffer(RingBuffer&& other) noexcept {                       // move constructor
+            swap(other);
+        }
+
+        RingBuffer& operator=(RingBuffer&& other) noexcept {            // move assignment
+            if (this != &other) {
+                RingBuffer blank;
+                swap(blank);
+                swap(other);
+            }
+            return *this;
+        }
+
+        ~RingBuffer() {
+            clear();
+            if (_data != nullptr) {
+                _alloc.deallocate(_data, _capacity);
+            }
+        }
+
+        bool empty() const {
+            return _size == 0;
+        }
+
+        std::size_t size() const {
+            return _size;
+        }
+
+        std::size_t capacity() const {
+            return _capacity;
+        }
+
+        T& front() {
+            return _data[_head];
+        }
+
+        T const& front() const {
+            return _data[_head];
+        }
+
+        T& back() {
+            return _data[(_head + _size - 1) & (_capacity - 1)];
+        }
+
+        T const& back() const {
+            return _data[(_head + _size - 1) & (_capacity - 1)];
+        }
+
+        void push(T const& data) {
+            emplace(data);
+        }
+
+        void push(T&& data) {
+            emplace(std::move(data));
+        }
+
+        template<typename... Args>
+        void emplace(Args&&... args) {
+            if (_size == _capacity) {
+                grow();
+            }
+
+            ::new (static_cast<void*>(_data + ((_head + _size) & (_capacity - 1)))) T(std::forward<Args>(args)...);
+            ++_size;
+        }
+
+        void pop() {
+            _data[_head].~T();
+            _head = (_head + 1) & (_capacity - 1);
+            --_size;
+        }
+
+        // keeps the array
+        void clear() {
+            while (_size > 0) {
+                pop();
+            }
+            _head = 0;
+        }
+
+        void swap(RingBuffer& other) noexcept {
+            std::swap(_data, other._data);
+            std::swap(_capacity, other._capacity);
+            std::swap(_head, other._head);
+            std::swap(_size, other._size);
+        }
+
+        static const std::size_t MIN_CAPACITY = 16;
+
+    private:
+        // moves the elements to the front of an array twice the size
+        void grow() {
+            std::size_t capacity = _capacity > 0 ? 2 * _capacity : MIN_CAPACITY;
+            T* data = _alloc.allocate(capacity);
+
+            for (std::size_t i = 0; i < _size; ++i) {
+                T& old = _data[(_head + i) & (_capacity - 1)];
+                ::new (static_cast<void*>(data + i)) T(std::move(old));
+                old.~T();
+            }
+
+            if (_data != nullptr) {
+                _alloc.deallocate(_data, _capacity);
+            }
+
+            _data = data;
+            _capacity = capacity;
+            _head = 0;
+        }
+
+        std::allocator<T> _alloc;
+        T* _data = nullptr;
+        std::size_t _capacity = 0;                      // zero or a power of two
+        std::size_t _head = 0;
+        std::size_t _size = 0;
+};
+
+template<typename T>
+const std::size_t RingBuffer<T>::MIN_CAPACITY;
+
+// ConcurrentQueue::clear() keeps the ring's high-water mark
+template<typename T>
+void clear_storage(RingBuffer<T>& storage) {
+    storage.clear();
+}
+
+#endif
@@ -0,0 +1,219 @@
+/*******************************************************************************
+ MIT License
+ Copyright (c) 2020 Orhan Kupusoglu
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+*******************************************************************************/
+
+/*!
+ * \anchor SynchronousQueue
+ *
+ * A zero-capacity rendezvous channel.
+ * push() blocks until a consumer has taken the element, which is moved directly
+ * from the producer's argument into the consumer's value, there is no storage in
+ * between.
+ * Both sides spin for a short while before they park on a condition variable,
+ * a waker only touches the mutex when somebody is actually parked.
+ * C++11
+ * [std::atomic](https://en.cppreference.com/w/cpp/atomic/atomic)
+ * [std::condition_variable](https://en.cppreference.com/w/cpp/thread/condition_variable)
+ */
+
+#ifndef SYNCHRONOUS_QUEUE_H
+#define SYNCHRONOUS_QUEUE_H
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <utility>
+
+template<typename T>
+class SynchronousQueue {
+    public:
+        SynchronousQueue() = default;                                   // default constructor
+        SynchronousQueue(const SynchronousQueue&) = delete;             // copy constructor
+        SynchronousQueue& operator=(const SynchronousQueue&) = delete;  // copy assignment
+        SynchronousQueue(SynchronousQueue&&) = delete;                  // move constructor
+        SynchronousQueue& operator=(SynchronousQueue &&) = delete;      // move assignment
+
+        // the consumer copies from data
+        void push(T const& data) {
+            offer(const_cast<T*>(&data), &SynchronousQueue::copy_into);
+        }
+
+        // the consumer moves from data
+        void push(T&& data) {
+            offer(&data, &SynchronousQueue::move_into);
+        }
+
+        // true if no producer is offering an element right now
+        bool empty() {
+            return _state.load() != OFFERED;
+        }
+
+        // succeeds only if a producer is already waiting
+        bool try_pop(T& value) {
+            if (!take(value)) {
+                return false;
+            }
+
+            wake();
+            return true;
+        }
+
+        void wait_and_pop(T& value) {
+            await([this, &value]() { return take(value); });
+            wake();
+        }
+
+        bool wait_and_pop_while(T& value,
+            std::chrono::milliseconds timeout_duration=std::chrono::seconds(1),
+            const std::chrono::milliseconds& check_interval=std::chrono::milliseconds(10)) {
+            if (spin([this, &value]() { return take(value); })) {
+                wake();
+                return true;
+            }
+
+            std::unique_lock<std::mutex> lock(_mutex);
+            ++_parked;
+
+            while (!take(value)) {
+                if (_condition.wait_for(lock, check_interval) == std::cv_status::timeout) {
+                    timeout_duration -= check_interval;
+                    if (timeout_duration <= std::chrono::milliseconds::zero() ) {
+                        --_parked;
+                        return false;
+                    }
+                }
+            }
+
+            --_parked;
+            lock.unlock();
+            wake();
+            return true;
+        }
+
+    private:
+        enum : int {
+            EMPTY,      // no producer in the slot
+            OFFERED,    // a producer waits for a consumer
+            CLAIMED     // a consumer is transferring the element
+        };
+
+        static const int SPIN_LIMIT = 1024;
+
+        // spinning on a single core only delays the thread it waits for
+        static int spin_limit() {
+            static const int limit = std::thread::hardware_concurrency() > 1 ? SPIN_LIMIT : 0;
+            return limit;
+        }
+
+        static void relax() {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#else
+            std::this_thread::yield();
+#endif
+        }
+
+        // only the transfer that is actually used gets instantiated, move-only types work
+        static void copy_into(T& value, T* item) {
+            value = *item;
+        }
+
+        static void move_into(T& value, T* item) {
+            value = std::move(*item);
+        }
+
+        void offer(T* data, void (*transfer)(T&, T*)) {
+            // one producer at a time occupies the slot
+            std::lock_guard<std::mutex> turn(_producer_mutex);
+
+            _item = data;
+            _transfer = transfer;
+            _state.store(OFFERED);
+            wake();
+
+            await([this]() { return _state.load() == EMPTY; });
+        }
+
+        // may run under _mutex, the caller wakes the producer afterwards
+        bool take(T& value) {
+            int expected = OFFERED;
+
+            if (!_state.compare_exchange_strong(expected, CLAIMED)) {
+                return false;
+            }
+
+            _transfer(value, _item);
+            _item = nullptr;
+            _state.store(EMPTY);
+            return true;
+        }
+
+        template<typename Predicate>
+        bool spin(Predicate ready) {
+            const int limit = spin_limit();
+
+            for (int i = 0; i < limit; ++i) {
+                if (ready()) {
+                    return true;
+                }
+                relax();
+            }
+
+            return false;
+        }
+
+        template<typename Predicate>
+        void await(Predicate ready) {
+            if (spin(ready)) {
+                return;
+            }
+
+            std::unique_lock<std::mutex> lock(_mutex);
+            ++_parked;
+
+            while (!ready()) {
+                _condition.wait(lock);
+            }
+
+            --_parked;
+        }
+
+        // _state and _parked are sequentially consistent: either the waker sees a parked
+        // thread or the parked thread sees the new state before it sleeps
+        void wake() {
+            if (_parked.load() > 0) {
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                }
+                _condition.notify_all();
+            }
+        }
+
+        T* _item = nullptr;
+        void (*_transfer)(T&, T*) = nullptr;
+        std::atomic<int> _state{EMPTY};
+        std::atomic<int> _parked{0};
+        std::mutex _producer_mutex;
+        std::mutex _mutex;
+        std::condition_variable _condition;
+};
+
+#endif
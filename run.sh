@@ -14,6 +14,13 @@ print_run ./build.sh
 printf "$SEP_2"
 print_run ./test-queue
 
+printf "$SEP_1"
+cd ..
+cd benchmark/
+print_run ./build.sh
+printf "$SEP_2"
+print_run ./bmark-queue
+
 printf "$SEP_1"
 cd ..
 cd example/
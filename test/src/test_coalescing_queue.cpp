@@ -0,0 +1,142 @@
+#include "gtest/gtest.h"
+#include "../../include/coalescing_queue.h"
+#include <cstdint>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+TEST(TestCoalescingQueue, LatestWins) {
+    CoalescingQueue<int, int> queue{};
+    const int n = 10;
+    int key = 0;
+    int val = 0;
+
+    for (int i = 1; i <= n; ++i) {
+        queue.push(1, i);
+        queue.push(2, -i);
+    }
+
+    ASSERT_EQ(queue.size(), 2);
+    ASSERT_EQ(queue.coalesced(), 2 * (n - 1));
+
+    ASSERT_TRUE(queue.try_pop(key, val));
+    ASSERT_EQ(key, 1);
+    ASSERT_EQ(val, n);
+
+    ASSERT_TRUE(queue.try_pop(key, val));
+    ASSERT_EQ(key, 2);
+    ASSERT_EQ(val, -n);
+
+    ASSERT_TRUE(queue.empty());
+}
+
+TEST(TestCoalescingQueue, MergeSum) {
+    CoalescingQueue<int, int> queue{};
+    const int n = 10;
+    int key = 0;
+    int val = 0;
+
+    auto add = [](int& pending, int const& incoming) { pending += incoming; };
+
+    for (int i = 1; i <= n; ++i) {
+        queue.push(i % 3, i, add);
+    }
+
+    std::vector<int> sums(3, 0);
+    while (queue.try_pop(key, val)) {
+        sums[key] = val;
+    }
+
+    ASSERT_EQ(sums, (std::vector<int>{3 + 6 + 9, 1 + 4 + 7 + 10, 2 + 5 + 8}));
+}
+
+TEST(TestCoalescingQueue, FirstArrivalOrder) {
+    CoalescingQueue<int, int> queue{};
+    std::vector<int> keys{};
+    int key = 0;
+    int val = 0;
+
+    queue.push(3, 0);
+    queue.push(1, 0);
+    queue.push(2, 0);
+    queue.push(3, 1);
+    queue.push(1, 1);
+
+    while (queue.try_pop(key, val)) {
+        keys.push_back(key);
+    }
+
+    ASSERT_EQ(keys, (std::vector<int>{3, 1, 2}));
+
+    // a popped key starts over at the tail
+    queue.push(2, 0);
+    queue.push(3, 0);
+    queue.try_pop(key, val);
+    ASSERT_EQ(key, 2);
+}
+
+TEST(TestCoalescingQueue, TaxicabPairs) {
+    using Pairs = std::vector<std::pair<uint32_t, uint32_t>>;
+    CoalescingQueue<uint32_t, Pairs> queue{};
+    uint32_t key = 0;
+    Pairs val{};
+    std::size_t taxicabs = 0;
+
+    auto merge = [](Pairs& pending, Pairs const& incoming) {
+        pending.insert(pending.end(), incoming.begin(), incoming.end());
+    };
+
+    // every sum of two cubes arrives once per pair, the consumer sees it once
+    for (uint32_t a = 1; a < 20; ++a) {
+        for (uint32_t b = a; b < 20; ++b) {
+            queue.push(a * a * a + b * b * b, Pairs{{a, b}}, merge);
+        }
+    }
+
+    while (queue.try_pop(key, val)) {
+        if (val.size() >= 2) {
+            ++taxicabs;
+            std::cout << "\t" << key << " = " << val[0].first << "^3 + " << val[0].second << "^3"
+                      << " = " << val[1].first << "^3 + " << val[1].second << "^3\n";
+        }
+    }
+
+    // 1729 and 4104
+    ASSERT_EQ(taxicabs, 2);
+}
+
+TEST(TestCoalescingQueue, SumWaitAndPop) {
+    CoalescingQueue<int, int> queue{};
+    const int n = 100;
+    const int expected_sum = n * (n + 1) / 2;
+    int sum = 0;
+
+    auto add = [](int& pending, int const& incoming) { pending += incoming; };
+
+    auto producer = [&queue, &add, n]() {
+        for (int i = 1; i <= n; ++i) {
+            queue.push(i % 4, i, add);
+        }
+    };
+
+    std::thread producer_thread = std::thread{producer};
+
+    // merged values keep the sum intact
+    auto consumer = [&queue, &sum, expected_sum]() {
+        int key = 0;
+        int val = 0;
+
+        while (sum < expected_sum) {
+            queue.wait_and_pop(key, val);
+            sum += val;
+        }
+    };
+
+    std::thread consumer_thread = std::thread{consumer};
+
+    producer_thread.join();
+    consumer_thread.join();
+
+    ASSERT_EQ(sum, expected_sum);
+    ASSERT_TRUE(queue.empty());
+}
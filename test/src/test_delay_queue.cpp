@@ -0,0 +1,123 @@
+#include "gtest/gtest.h"
+#include "../../include/delay_queue.h"
+#include <iostream>
+#include <random>
+#include <vector>
+
+TEST(TestDelayQueue, NotBeforeDeadline) {
+    DelayQueue<int> queue{};
+    int val = 0;
+
+    queue.push(1, std::chrono::milliseconds{50});
+
+    ASSERT_FALSE(queue.try_pop(val));
+    ASSERT_EQ(queue.size(), 1);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{60});
+
+    ASSERT_TRUE(queue.try_pop(val));
+    ASSERT_EQ(val, 1);
+    ASSERT_TRUE(queue.empty());
+}
+
+TEST(TestDelayQueue, DeadlineOrder) {
+    DelayQueue<int> queue{};
+    const int n = 10;
+    const std::chrono::milliseconds step{20};
+    std::vector<int> values{};
+    int val = 0;
+
+    auto t_start = DelayQueue<int>::clock::now();
+
+    // pushed in reverse, popped in deadline order
+    for (int i = n; i >= 1; --i) {
+        queue.push(i, t_start + i * step);
+    }
+
+    for (int j = 1; j <= n; ++j) {
+        queue.wait_and_pop(val);
+        ASSERT_TRUE(DelayQueue<int>::clock::now() >= t_start + val * step);
+        values.push_back(val);
+    }
+
+    for (int j = 1; j <= n; ++j) {
+        ASSERT_EQ(values[j - 1], j);
+    }
+
+    ASSERT_TRUE(queue.empty());
+}
+
+TEST(TestDelayQueue, EarlierItemWakesConsumer) {
+    DelayQueue<int> queue{};
+    const std::chrono::milliseconds late{2000};
+    const std::chrono::milliseconds early{50};
+    int val = 0;
+
+    queue.push(1, late);
+
+    auto t_start = DelayQueue<int>::clock::now();
+
+    std::thread producer_thread = std::thread{[&queue, early]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds{20});
+        queue.push(2, early);
+    }};
+
+    queue.wait_and_pop(val);
+    auto elapsed = DelayQueue<int>::clock::now() - t_start;
+    producer_thread.join();
+
+    ASSERT_EQ(val, 2);
+    ASSERT_TRUE(elapsed < late);
+
+    std::cout << "Woke up for the earlier element after "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << "ms.\n";
+
+    ASSERT_EQ(queue.size(), 1);
+}
+
+TEST(TestDelayQueue, WaitAndPopWhileWithTimeout) {
+    DelayQueue<int> queue{};
+    int val = 0;
+
+    queue.push(1, std::chrono::milliseconds{200});
+
+    ASSERT_FALSE(queue.wait_and_pop_while(val, std::chrono::milliseconds{50}));
+    ASSERT_TRUE(queue.wait_and_pop_while(val, std::chrono::milliseconds{500}));
+    ASSERT_EQ(val, 1);
+}
+
+TEST(TestDelayQueue, ManyTimers) {
+    // a fine resolution spreads the timers over three levels of the wheel
+    DelayQueue<uint32_t> queue{std::chrono::microseconds{10}};
+    const uint32_t n = 100000;
+    const int max_delay_ms = 300;
+    std::vector<DelayQueue<uint32_t>::clock::time_point> deadlines(n);
+    std::mt19937 gen{42};
+    std::uniform_int_distribution<int> dist{0, max_delay_ms * 1000};
+    uint32_t early = 0;
+
+    auto t_start = DelayQueue<uint32_t>::clock::now();
+
+    for (uint32_t i = 0; i < n; ++i) {
+        deadlines[i] = t_start + std::chrono::microseconds{dist(gen)};
+        queue.push(i, deadlines[i]);
+    }
+
+    ASSERT_EQ(queue.size(), n);
+
+    uint32_t val = 0;
+    for (uint32_t j = 0; j < n; ++j) {
+        queue.wait_and_pop(val);
+        if (DelayQueue<uint32_t>::clock::now() < deadlines[val]) {
+            ++early;
+        }
+    }
+
+    auto elapsed = DelayQueue<uint32_t>::clock::now() - t_start;
+
+    std::cout << "Popped " << n << " timers in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << "ms.\n";
+
+    ASSERT_EQ(early, 0);
+    ASSERT_TRUE(queue.empty());
+}
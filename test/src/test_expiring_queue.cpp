@@ -0,0 +1,136 @@
+#include "gtest/gtest.h"
+#include "../../include/expiring_queue.h"
+#include <iostream>
+#include <vector>
+
+TEST(TestExpiringQueue, NoExpiry) {
+    ExpiringQueue<int> queue{};
+    const int n = 10;
+    const int expected_sum = n * (n + 1) / 2;
+    int sum = 0;
+
+    auto producer = [&queue, n]() {
+        for (int i = 1; i <= n; ++i) {
+            queue.push(i);
+        }
+    };
+
+    auto consumer = [&queue, &sum, n]() {
+        int val = 0;
+
+        for (int j = 1; j <= n; ++j) {
+            queue.wait_and_pop(val);
+            sum += val;
+        }
+    };
+
+    std::thread producer_thread = std::thread{producer};
+    std::thread consumer_thread = std::thread{consumer};
+
+    producer_thread.join();
+    consumer_thread.join();
+
+    ASSERT_EQ(sum, expected_sum);
+    ASSERT_EQ(queue.expired(), 0);
+    ASSERT_EQ(queue.dropped(), 0);
+    ASSERT_TRUE(queue.empty());
+}
+
+TEST(TestExpiringQueue, SkipExpired) {
+    ExpiringQueue<int> queue{std::chrono::milliseconds{50}};
+    const int n = 10;
+    int val = 0;
+
+    for (int i = 1; i <= n; ++i) {
+        queue.push(i);
+    }
+
+    // let the whole backlog go stale
+    std::this_thread::sleep_for(std::chrono::milliseconds{100});
+
+    queue.push(n + 1);
+
+    ASSERT_TRUE(queue.try_pop(val));
+    ASSERT_EQ(val, n + 1);
+    ASSERT_EQ(queue.expired(), n);
+
+    std::cout << "Skipped " << queue.expired() << " expired elements.\n";
+
+    ASSERT_TRUE(queue.empty());
+}
+
+TEST(TestExpiringQueue, WaitAndPopWhileExpired) {
+    ExpiringQueue<int> queue{std::chrono::milliseconds{20}};
+    const std::chrono::milliseconds timeout{100};
+    const std::chrono::milliseconds check{5};
+    int val = 0;
+
+    queue.push(1);
+    std::this_thread::sleep_for(std::chrono::milliseconds{40});
+
+    ASSERT_FALSE(queue.wait_and_pop_while(val, timeout, check));
+    ASSERT_EQ(queue.expired(), 1);
+}
+
+TEST(TestExpiringQueue, DropOldest) {
+    const std::size_t limit = 5;
+    ExpiringQueue<int> queue{std::chrono::milliseconds::zero(), limit, DropPolicy::drop_oldest};
+    const int n = 10;
+    std::vector<int> values{};
+    int val = 0;
+
+    for (int i = 1; i <= n; ++i) {
+        ASSERT_TRUE(queue.push(i));
+    }
+
+    ASSERT_EQ(queue.size(), limit);
+    ASSERT_EQ(queue.dropped(), n - limit);
+
+    while (queue.try_pop(val)) {
+        values.push_back(val);
+    }
+
+    // the freshest elements survive
+    ASSERT_EQ(values, (std::vector<int>{6, 7, 8, 9, 10}));
+}
+
+TEST(TestExpiringQueue, DropNewest) {
+    const std::size_t limit = 5;
+    ExpiringQueue<int> queue{std::chrono::milliseconds::zero(), limit, DropPolicy::drop_newest};
+    const int n = 10;
+    std::vector<int> values{};
+    int val = 0;
+
+    for (int i = 1; i <= n; ++i) {
+        ASSERT_EQ(queue.push(i), i <= static_cast<int>(limit));
+    }
+
+    ASSERT_EQ(queue.size(), limit);
+    ASSERT_EQ(queue.dropped(), n - limit);
+
+    while (queue.try_pop(val)) {
+        values.push_back(val);
+    }
+
+    ASSERT_EQ(values, (std::vector<int>{1, 2, 3, 4, 5}));
+}
+
+TEST(TestExpiringQueue, SoftLimitPrefersExpired) {
+    const std::size_t limit = 3;
+    ExpiringQueue<int> queue{std::chrono::milliseconds{20}, limit, DropPolicy::drop_newest};
+    int val = 0;
+
+    for (int i = 1; i <= 3; ++i) {
+        queue.push(i);
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{40});
+
+    // the stale backlog makes room, nothing fresh is shed
+    ASSERT_TRUE(queue.push(4));
+    ASSERT_EQ(queue.dropped(), 0);
+    ASSERT_EQ(queue.expired(), 3);
+
+    ASSERT_TRUE(queue.try_pop(val));
+    ASSERT_EQ(val, 4);
+}
@@ -0,0 +1,135 @@
+#include "gtest/gtest.h"
+#include "../../include/fair_queue.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+TEST(TestFairQueue, NoisyTenant) {
+    FairQueue<std::string, int> queue{};
+    const int noisy = 100;
+    const int quiet = 5;
+    int val = 0;
+    int quiet_served = 0;
+
+    // the noisy tenant fills the queue first
+    for (int i = 1; i <= noisy; ++i) {
+        queue.push("noisy", i);
+    }
+
+    for (int i = 1; i <= quiet; ++i) {
+        queue.push("quiet", -i);
+    }
+
+    ASSERT_EQ(queue.size(), noisy + quiet);
+    ASSERT_EQ(queue.tenants(), 2);
+
+    // with equal weights the quiet tenant is served every second pop
+    for (int j = 0; j < 2 * quiet; ++j) {
+        ASSERT_TRUE(queue.try_pop(val));
+        if (val < 0) {
+            ++quiet_served;
+        }
+    }
+
+    ASSERT_EQ(quiet_served, quiet);
+    ASSERT_EQ(queue.size("quiet"), 0);
+
+    std::cout << "Quiet tenant served " << quiet_served << " times in the first " << 2 * quiet << " pops.\n";
+}
+
+TEST(TestFairQueue, Weights) {
+    FairQueue<int, int> queue{};
+    const int n = 12;
+    std::vector<int> keys{};
+    int val = 0;
+
+    queue.set_weight(1, 3);
+
+    for (int i = 0; i < n; ++i) {
+        queue.push(1, 1);
+        queue.push(2, 2);
+    }
+
+    for (int j = 0; j < 8; ++j) {
+        ASSERT_TRUE(queue.try_pop(val));
+        keys.push_back(val);
+    }
+
+    ASSERT_EQ(keys, (std::vector<int>{1, 1, 1, 2, 1, 1, 1, 2}));
+}
+
+TEST(TestFairQueue, FifoPerTenant) {
+    FairQueue<int, int> queue{};
+    const int n = 10;
+    std::vector<int> last{0, 0, 0};
+    int val = 0;
+
+    for (int i = 1; i <= n; ++i) {
+        for (int key = 0; key < 3; ++key) {
+            queue.push(key, key * 100 + i);
+        }
+    }
+
+    while (queue.try_pop(val)) {
+        int key = val / 100;
+        ASSERT_EQ(val % 100, last[key] + 1);
+        last[key] = val % 100;
+    }
+
+    ASSERT_EQ(last, (std::vector<int>{n, n, n}));
+}
+
+TEST(TestFairQueue, ReclaimEmptyTenants) {
+    FairQueue<int, int> queue{};
+    const int n = 100;
+    int val = 0;
+
+    for (int key = 0; key < n; ++key) {
+        queue.push(key, key);
+    }
+
+    ASSERT_EQ(queue.tenants(), n);
+
+    while (queue.try_pop(val)) {
+    }
+
+    ASSERT_EQ(queue.tenants(), 0);
+    ASSERT_TRUE(queue.empty());
+}
+
+TEST(TestFairQueue, SumWaitAndPop) {
+    FairQueue<int, int> queue{};
+    const int producers = 3;
+    const int n = 100;
+    const int expected_sum = producers * n * (n + 1) / 2;
+    int sum = 0;
+    std::vector<std::thread> producer_threads{};
+
+    for (int p = 0; p < producers; ++p) {
+        producer_threads.push_back(std::thread{[&queue, n, p]() {
+            for (int i = 1; i <= n; ++i) {
+                queue.push(p, i);
+            }
+        }});
+    }
+
+    auto consumer = [&queue, &sum, expected_sum]() {
+        int val = 0;
+
+        while (sum < expected_sum) {
+            queue.wait_and_pop(val);
+            sum += val;
+        }
+    };
+
+    std::thread consumer_thread = std::thread{consumer};
+
+    for (auto& t : producer_threads) {
+        t.join();
+    }
+
+    consumer_thread.join();
+
+    ASSERT_EQ(sum, expected_sum);
+    ASSERT_TRUE(queue.empty());
+}
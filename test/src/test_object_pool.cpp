@@ -0,0 +1,202 @@
+#include "gtest/gtest.h"
+#include "../../include/concurrent_queue.h"
+#include "../../include/object_pool.h"
+#include <iostream>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST(TestObjectPool, ReuseKeepsCapacity) {
+    ObjectPool<std::vector<int>> pool{};
+
+    auto handle = pool.acquire();
+    std::vector<int>* object = handle.get();
+    handle->resize(1000);
+    handle->clear();
+    handle.reset();
+
+    ASSERT_FALSE(handle);
+
+    // the thread's cache hands the same object out again
+    auto again = pool.acquire();
+    ASSERT_EQ(again.get(), object);
+    ASSERT_GE(again->capacity(), 1000);
+    ASSERT_EQ(pool.allocations(), 1);
+}
+
+TEST(TestObjectPool, MoveOnlyHandle) {
+    ObjectPool<std::string> pool{4};
+    ConcurrentQueue<ObjectPool<std::string>::Handle> queue{};
+
+    auto handle = pool.acquire();
+    *handle = "taxicab";
+    queue.push(std::move(handle));
+
+    ASSERT_FALSE(handle);
+
+    ObjectPool<std::string>::Handle value{};
+    ASSERT_TRUE(queue.try_pop(value));
+    ASSERT_EQ(*value, "taxicab");
+    ASSERT_EQ(pool.capacity(), 4);
+}
+
+TEST(TestObjectPool, CrossThreadSteadyState) {
+    ObjectPool<std::vector<uint32_t>> pool{};
+    ConcurrentQueue<ObjectPool<std::vector<uint32_t>>::Handle> queue{};
+    const uint32_t n = 100000;
+    const int max_in_flight = 256;
+    std::atomic<int> in_flight{0};
+    uint64_t sum = 0;
+
+    std::thread consumer_thread = std::thread{[&]() {
+        ObjectPool<std::vector<uint32_t>>::Handle batch{};
+
+        for (uint32_t j = 0; j < n; ++j) {
+            queue.wait_and_pop(batch);
+            sum += (*batch)[0];
+            // freed on the consumer thread
+            batch.reset();
+            --in_flight;
+        }
+    }};
+
+    std::size_t warm = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+        while (in_flight >= max_in_flight) {
+            std::this_thread::yield();
+        }
+
+        auto batch = pool.acquire();
+        batch->clear();
+        batch->push_back(i);
+        ++in_flight;
+        queue.push(std::move(batch));
+
+        if (i == n / 2) {
+            warm = pool.allocations();
+        }
+    }
+
+    consumer_thread.join();
+
+    std::cout << "Passed " << n << " batches with " << pool.capacity() << " pooled objects.\n";
+
+    ASSERT_EQ(sum, static_cast<uint64_t>(n) * (n - 1) / 2);
+    ASSERT_EQ(pool.allocations(), warm);
+    ASSERT_LE(pool.capacity(), 2 * max_in_flight);
+}
+
+struct Owned {
+    std::atomic<int> owner{0};
+};
+
+TEST(TestObjectPool, NoObjectTwice) {
+    ObjectPool<Owned> pool{8};
+    const int n_threads = 4;
+    const int rounds = 20000;
+    std::atomic<int> twice{0};
+    std::vector<std::thread> threads{};
+
+    for (int t = 0; t < n_threads; ++t) {
+        threads.push_back(std::thread{[&pool, &twice, t]() {
+            std::vector<ObjectPool<Owned>::Handle> held{};
+
+            for (int r = 0; r < rounds; ++r) {
+                // acquire a few, release them in a different order
+                for (int k = 0; k < 1 + (r + t) % 5; ++k) {
+                    auto handle = pool.acquire();
+                    int free = 0;
+                    if (!handle->owner.compare_exchange_strong(free, t + 1)) {
+                        ++twice;
+                    }
+                    held.push_back(std::move(handle));
+                }
+
+                while (held.size() > 2) {
+                    held.front()->owner = 0;
+                    held.erase(held.begin());
+                }
+            }
+
+            for (auto& handle : held) {
+                handle->owner = 0;
+            }
+        }});
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(twice, 0);
+}
+
+TEST(TestObjectPool, CacheOutlivesPool) {
+    std::atomic<bool> released{false};
+    std::atomic<bool> destroyed{false};
+    std::thread worker_thread{};
+
+    {
+        ObjectPool<std::string> pool{};
+
+        worker_thread = std::thread{[&pool, &released, &destroyed]() {
+            pool.acquire().reset();
+            released = true;
+
+            while (!destroyed) {
+                std::this_thread::yield();
+            }
+            // the thread's cache still refers to the destroyed pool on exit
+        }};
+
+        while (!released) {
+            std::this_thread::yield();
+        }
+    }
+
+    destroyed = true;
+    worker_thread.join();
+
+    // a new pool of the same type on this thread drops the stale cache
+    ObjectPool<std::string> pool{};
+    ASSERT_TRUE(static_cast<bool>(pool.acquire()));
+}
+
+struct Counted {
+    Counted() { ++live; }
+    ~Counted() { --live; }
+    static std::atomic<int> live;
+};
+
+std::atomic<int> Counted::live{0};
+
+TEST(TestObjectPool, DestroyFreesObjects) {
+    std::atomic<bool> released{false};
+    std::atomic<bool> destroyed{false};
+    std::thread worker_thread{};
+
+    {
+        ObjectPool<Counted> pool{};
+
+        worker_thread = std::thread{[&pool, &released, &destroyed]() {
+            pool.acquire().reset();
+            released = true;
+
+            while (!destroyed) {
+                std::this_thread::yield();
+            }
+        }};
+
+        while (!released) {
+            std::this_thread::yield();
+        }
+
+        EXPECT_GT(Counted::live.load(), 0);
+    }
+
+    // the worker's cache still exists, the objects are gone with the pool
+    EXPECT_EQ(Counted::live.load(), 0);
+
+    destroyed = true;
+    worker_thread.join();
+}
@@ -0,0 +1,161 @@
+#include "gtest/gtest.h"
+#include "../../include/partitioned_queue.h"
+#include <iostream>
+#include <map>
+#include <thread>
+#include <utility>
+#include <vector>
+
+TEST(TestPartitionedQueue, KeyAffinityInOrder) {
+    PartitionedQueue<int, std::pair<int, int>> queue{4};
+    const int keys = 100;
+    const int n = 20;
+
+    for (int i = 0; i < n; ++i) {
+        for (int key = 0; key < keys; ++key) {
+            queue.push(key, {key, i});
+        }
+    }
+
+    ASSERT_EQ(queue.size(), keys * n);
+
+    std::map<int, int> last{};
+    for (std::size_t p = 0; p < queue.partitions(); ++p) {
+        std::pair<int, int> val{};
+
+        while (queue.try_pop(p, val)) {
+            ASSERT_EQ(queue.partition_of(val.first), p);
+
+            auto it = last.find(val.first);
+            if (it != last.end()) {
+                ASSERT_EQ(it->second + 1, val.second);
+            }
+            last[val.first] = val.second;
+        }
+    }
+
+    ASSERT_EQ(last.size(), keys);
+    ASSERT_TRUE(queue.empty());
+}
+
+TEST(TestPartitionedQueue, StatefulConsumers) {
+    const std::size_t size_p = 4;
+    const int keys = 1000;
+    const int n = 50;
+    const int done = -1;
+    PartitionedQueue<int, std::pair<int, int>> queue{size_p};
+    // every consumer owns the counts of its keys, no lock
+    std::vector<std::map<int, int>> counts(size_p);
+    std::vector<std::thread> consumers{};
+
+    for (std::size_t p = 0; p < size_p; ++p) {
+        consumers.push_back(std::thread{[&queue, &counts, p]() {
+            std::pair<int, int> val{};
+
+            while (true) {
+                queue.wait_and_pop(p, val);
+                if (val.first == done) {
+                    break;
+                }
+                ++counts[p][val.first];
+            }
+        }});
+    }
+
+    std::thread producer_thread = std::thread{[&queue]() {
+        for (int i = 0; i < n; ++i) {
+            for (int key = 0; key < keys; ++key) {
+                queue.push(key, {key, i});
+            }
+        }
+    }};
+
+    producer_thread.join();
+
+    for (std::size_t p = 0; p < size_p; ++p) {
+        queue.partition(p).push({done, 0});
+    }
+
+    for (auto& consumer : consumers) {
+        consumer.join();
+    }
+
+    std::size_t total_keys = 0;
+    for (std::size_t p = 0; p < size_p; ++p) {
+        total_keys += counts[p].size();
+        for (auto& count : counts[p]) {
+            ASSERT_EQ(count.second, n);
+        }
+
+        PartitionStats stats = queue.stats(p);
+        std::cout << "partition " << p << ": " << stats.pushed << " pushed, " << stats.buckets << " buckets\n";
+        ASSERT_EQ(stats.depth, 0);
+        ASSERT_EQ(stats.buckets, 64);
+    }
+
+    ASSERT_EQ(total_keys, keys);
+}
+
+TEST(TestPartitionedQueue, RebalanceSkew) {
+    PartitionedQueue<int, int> queue{2, 8};
+    std::vector<std::size_t> moves{};
+
+    queue.set_rebalance_hook([&moves](std::size_t bucket, std::size_t from, std::size_t to) {
+        ASSERT_NE(from, to);
+        moves.push_back(bucket);
+    });
+
+    // all load on partition 0: its buckets are the even ones
+    for (int i = 0; i < 8000; ++i) {
+        queue.push((i % 4) * 2, i);
+    }
+
+    ASSERT_EQ(queue.stats(0).pushed, 8000);
+    ASSERT_EQ(queue.stats(1).pushed, 0);
+
+    queue.clear();
+    std::size_t moved = queue.rebalance();
+
+    ASSERT_EQ(moved, 2);
+    ASSERT_EQ(moves.size(), 2);
+    ASSERT_EQ(queue.stats(1).buckets, 10);
+
+    for (int i = 0; i < 8000; ++i) {
+        queue.push((i % 4) * 2, i);
+    }
+
+    ASSERT_EQ(queue.partition(0).size(), 4000);
+    ASSERT_EQ(queue.partition(1).size(), 4000);
+
+    // balanced now, nothing to move
+    ASSERT_EQ(queue.rebalance(), 0);
+}
+
+TEST(TestPartitionedQueue, MoveBucket) {
+    PartitionedQueue<int, int> queue{3, 1};
+    int val = 0;
+
+    std::size_t bucket = queue.bucket_of(7);
+    queue.move_bucket(bucket, 2);
+    queue.push(7, 70);
+
+    ASSERT_EQ(queue.partition_of(7), 2);
+    ASSERT_TRUE(queue.wait_and_pop_while(2, val, std::chrono::milliseconds{10}, std::chrono::milliseconds{1}));
+    ASSERT_EQ(val, 70);
+    ASSERT_FALSE(queue.wait_and_pop_while(2, val, std::chrono::milliseconds{10}, std::chrono::milliseconds{1}));
+}
+
+TEST(TestPartitionedQueue, MoveBucketOutOfRange) {
+    PartitionedQueue<int, int> queue{3, 2};
+    int val = 0;
+
+    std::size_t bucket = queue.bucket_of(7);
+    ASSERT_THROW(queue.move_bucket(bucket, 3), std::out_of_range);
+    ASSERT_THROW(queue.move_bucket(6, 0), std::out_of_range);
+
+    // the table is unchanged
+    std::size_t p = queue.partition_of(7);
+    queue.push(7, 70);
+    ASSERT_TRUE(queue.wait_and_pop_while(p, val, std::chrono::milliseconds{10}, std::chrono::milliseconds{1}));
+    ASSERT_EQ(val, 70);
+}
@@ -0,0 +1,181 @@
+#include "gtest/gtest.h"
+#include "../../include/pipeline.h"
+#include "../../include/synchronous_queue.h"
+#include <iostream>
+#include <atomic>
+#include <vector>
+#include <set>
+#include <mutex>
+#include <thread>
+
+template<typename M>
+using PipelineSynchronousQueue = SynchronousQueue<M>;
+
+TEST(TestPipeline, EndOfStream) {
+    Pipeline pipeline;
+    const int n = 1000;
+    const std::size_t sources = 3;
+    std::atomic<int> sum{0};
+    std::atomic<int> finished{0};
+
+    auto& numbers = pipeline.source<int>("count", sources, [n](std::size_t, PipelineEmitter<int>& emit) {
+        for (int i = 1; i <= n; ++i) {
+            emit(i);
+        }
+    });
+
+    auto& squares = pipeline.transform<int, int>("double", 4, numbers, [](const int& x, PipelineEmitter<int>& emit) {
+        emit(2 * x);
+    });
+
+    pipeline.sink<int>("sum", 2, squares,
+        [&sum](const int& x) {
+            sum += x;
+        },
+        [&finished](std::size_t) {
+            ++finished;
+        });
+
+    pipeline.run();
+
+    ASSERT_EQ(sum, static_cast<int>(sources) * n * (n + 1));
+    ASSERT_EQ(finished, 2);
+
+    auto stats = pipeline.stats();
+    ASSERT_EQ(stats.size(), 3);
+    for (auto& stage : stats) {
+        ASSERT_EQ(stage.items, sources * n);
+        std::cout << stage.name << ": " << stage.threads << " threads, " << stage.throughput() << " items/s\n";
+    }
+}
+
+TEST(TestPipeline, FlushAtEndOfStream) {
+    Pipeline pipeline;
+    std::vector<int> out{};
+
+    auto& numbers = pipeline.source<int>("count", 1, [](std::size_t, PipelineEmitter<int>& emit) {
+        for (int i = 1; i <= 10; ++i) {
+            emit(i);
+        }
+    });
+
+    int total = 0;
+    auto& totals = pipeline.transform<int, int>("total", 1, numbers,
+        [&total](const int& x, PipelineEmitter<int>&) {
+            total += x;
+        },
+        [&total](std::size_t, PipelineEmitter<int>& emit) {
+            emit(total);
+        });
+
+    pipeline.sink<int>("collect", 1, totals, [&out](const int& x) {
+        out.push_back(x);
+    });
+
+    pipeline.run();
+
+    ASSERT_EQ(out.size(), 1);
+    ASSERT_EQ(out[0], 55);
+}
+
+TEST(TestPipeline, KeyedChannel) {
+    Pipeline pipeline;
+    const int n = 1000;
+    const std::size_t threads = 3;
+    std::mutex mutex;
+    std::vector<std::set<std::thread::id>> owners(threads);
+    std::atomic<int> count{0};
+    std::atomic<int> finished{0};
+
+    auto& numbers = pipeline.source<int>("count", 2, [n](std::size_t, PipelineEmitter<int>& emit) {
+        for (int i = 0; i < n; ++i) {
+            emit(i);
+        }
+    });
+    numbers.key_by([threads](const int& x) { return static_cast<std::size_t>(x) % threads; });
+
+    pipeline.sink<int>("owner", threads, numbers,
+        [&mutex, &owners, &count, threads](const int& x) {
+            std::lock_guard<std::mutex> lock{mutex};
+            owners[static_cast<std::size_t>(x) % threads].insert(std::this_thread::get_id());
+            ++count;
+        },
+        [&finished](std::size_t) {
+            ++finished;
+        });
+
+    pipeline.run();
+
+    ASSERT_EQ(count, 2 * n);
+    // every thread got its end-of-stream marker
+    ASSERT_EQ(finished, static_cast<int>(threads));
+
+    // a key has one thread, a thread has one key
+    std::set<std::thread::id> all{};
+    for (auto& owner : owners) {
+        ASSERT_EQ(owner.size(), 1);
+        all.insert(*owner.begin());
+    }
+    ASSERT_EQ(all.size(), threads);
+}
+
+TEST(TestPipeline, BoundedChannel) {
+    Pipeline pipeline;
+    const int n = 10000;
+    const std::size_t capacity = 8;
+    std::atomic<int> in_flight{0};
+    std::atomic<int> max_in_flight{0};
+    std::atomic<int> received{0};
+
+    auto& numbers = pipeline.source<int>("count", 2, [&](std::size_t, PipelineEmitter<int>& emit) {
+        for (int i = 0; i < n; ++i) {
+            int now = ++in_flight;
+            int max = max_in_flight;
+            while (now > max && !max_in_flight.compare_exchange_weak(max, now)) {}
+            emit(i);
+        }
+    }, capacity);
+
+    pipeline.sink<int>("drain", 1, numbers, [&](const int&) {
+        --in_flight;
+        ++received;
+    });
+
+    pipeline.run();
+
+    ASSERT_EQ(received, 2 * n);
+    // counted before a push blocks and after a pop frees the slot, one extra per thread
+    ASSERT_LE(max_in_flight, static_cast<int>(capacity) + 3);
+}
+
+TEST(TestPipeline, CustomQueue) {
+    Pipeline pipeline;
+    std::vector<int> out{};
+
+    auto& numbers = pipeline.source<int, PipelineSynchronousQueue>("count", 1, [](std::size_t, PipelineEmitter<int>& emit) {
+        for (int i = 0; i < 100; ++i) {
+            emit(i);
+        }
+    });
+
+    pipeline.sink<int>("collect", 1, numbers, [&out](const int& x) {
+        out.push_back(x);
+    });
+
+    pipeline.run();
+
+    ASSERT_EQ(out.size(), 100);
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_EQ(out[i], i);
+    }
+}
+
+TEST(TestPipeline, ChannelWithoutConsumer) {
+    Pipeline pipeline;
+
+    pipeline.source<int>("count", 1, [](std::size_t, PipelineEmitter<int>& emit) {
+        emit(1);
+    });
+
+    ASSERT_THROW(pipeline.run(), std::logic_error);
+}
@@ -1,6 +1,8 @@
 #include "gtest/gtest.h"
 #include "../../include/concurrent_queue.h"
 #include <algorithm>
+#include <array>
+#include <vector>
 #include <iostream>
 
 TEST(TestConcurrentQueue, SizeAndClear) {
@@ -472,3 +474,152 @@ TEST(TestConcurrentQueue, SumWaitAndPopWhileWithTimeout4) {
 
     ASSERT_TRUE(queue.empty());
 }
+
+TEST(TestConcurrentQueue, PopBatchFull) {
+    ConcurrentQueue<int> queue{};
+    const std::chrono::milliseconds linger{5000};
+    const int n = 10;
+    std::vector<int> batch{};
+
+    auto producer = [&queue, n]() {
+        for (int i = 1; i <= n; ++i) {
+            queue.push(i);
+            std::this_thread::sleep_for(std::chrono::milliseconds{5});
+        }
+    };
+
+    auto t_start = std::chrono::steady_clock::now();
+    std::thread producer_thread = std::thread{producer};
+
+    // a full batch returns long before the linger time
+    std::size_t size = queue.pop_batch(batch, n, linger);
+    auto elapsed = std::chrono::steady_clock::now() - t_start;
+
+    producer_thread.join();
+
+    ASSERT_EQ(size, n);
+    ASSERT_EQ(batch.size(), n);
+    ASSERT_TRUE(elapsed < linger);
+
+    for (int i = 1; i <= n; ++i) {
+        ASSERT_EQ(batch[i - 1], i);
+    }
+
+    ASSERT_TRUE(queue.empty());
+}
+
+TEST(TestConcurrentQueue, PopBatchLinger) {
+    ConcurrentQueue<int> queue{};
+    const std::chrono::milliseconds linger{50};
+    const int n = 3;
+    std::vector<int> batch{};
+
+    for (int i = 1; i <= n; ++i) {
+        queue.push(i);
+    }
+
+    auto t_start = std::chrono::steady_clock::now();
+
+    // fewer elements than asked for, returns after lingering
+    std::size_t size = queue.pop_batch(batch, 100, linger);
+    auto elapsed = std::chrono::steady_clock::now() - t_start;
+
+    std::cout << "Popped a batch of " << size << " after "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << "ms.\n";
+
+    ASSERT_EQ(size, n);
+    ASSERT_TRUE(elapsed >= linger);
+    ASSERT_TRUE(elapsed < 2 * linger);
+    ASSERT_TRUE(queue.empty());
+}
+
+TEST(TestConcurrentQueue, PopBatchLingerFromArrival) {
+    ConcurrentQueue<int> queue{};
+    const std::chrono::milliseconds delay{30};
+    const std::chrono::milliseconds linger{50};
+    std::vector<int> batch{};
+
+    auto t_start = std::chrono::steady_clock::now();
+
+    std::thread producer_thread{[&queue, delay]() {
+        std::this_thread::sleep_for(delay);
+        queue.push(1);
+    }};
+
+    // the linger starts with the first element, not with the call
+    std::size_t size = queue.pop_batch(batch, 100, linger);
+    auto elapsed = std::chrono::steady_clock::now() - t_start;
+    producer_thread.join();
+
+    std::cout << "Popped a batch of " << size << " after "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << "ms.\n";
+
+    ASSERT_EQ(size, 1u);
+    ASSERT_TRUE(elapsed >= delay + linger);
+}
+
+TEST(TestConcurrentQueue, PopBatchMixedWakeups) {
+    ConcurrentQueue<int> queue{};
+    const std::chrono::milliseconds settle{20};
+    const std::chrono::milliseconds linger{300};
+    const int n = 10;
+    std::vector<int> large{};
+    std::vector<int> small{};
+
+    // lingers for 100 elements after the first push
+    std::thread large_thread{[&queue, &large, linger]() {
+        queue.pop_batch(large, 100, linger);
+    }};
+
+    queue.push(1);
+    std::this_thread::sleep_for(settle);
+
+    // lingers for 2, the next push fills its batch
+    std::thread small_thread{[&queue, &small, linger]() {
+        queue.pop_batch(small, 2, linger);
+    }};
+
+    std::this_thread::sleep_for(settle);
+    queue.push(2);
+    small_thread.join();
+
+    // pushes below the large batch do not wake it
+    for (int i = 0; i < n; ++i) {
+        queue.push(3 + i);
+        std::this_thread::sleep_for(std::chrono::milliseconds{2});
+    }
+    large_thread.join();
+
+    std::cout << "Lingering wakeups short of the batch: " << queue.batch_wakeups() << '\n';
+
+    ASSERT_EQ(small.size(), 2u);
+    ASSERT_EQ(large.size(), static_cast<std::size_t>(n));
+    ASSERT_LE(queue.batch_wakeups(), 1u);
+}
+
+TEST(TestConcurrentQueue, PopBatchBacklog) {
+    ConcurrentQueue<int> queue{};
+    const std::chrono::milliseconds linger{10};
+    const int n = 25;
+    const int max_n = 10;
+    const int expected_sum = n * (n + 1) / 2;
+    int sum = 0;
+    std::vector<std::size_t> sizes{};
+
+    for (int i = 1; i <= n; ++i) {
+        queue.push(i);
+    }
+
+    while (sum < expected_sum) {
+        std::vector<int> batch{};
+        sizes.push_back(queue.pop_batch(batch, max_n, linger));
+
+        for (int val : batch) {
+            sum += val;
+        }
+    }
+
+    ASSERT_EQ(sum, expected_sum);
+    ASSERT_EQ(sizes, (std::vector<std::size_t>{10, 10, 5}));
+    ASSERT_TRUE(queue.empty());
+}
@@ -0,0 +1,121 @@
+#include "gtest/gtest.h"
+#include "../../include/concurrent_queue.h"
+#include "../../include/reorder_buffer.h"
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+TEST(TestReorderBuffer, ReleaseInOrder) {
+    ReorderBuffer<int> buffer{8};
+    int val = 0;
+
+    ASSERT_TRUE(buffer.push(2, 20));
+    ASSERT_TRUE(buffer.push(1, 10));
+
+    // sequence 0 is missing
+    ASSERT_FALSE(buffer.try_pop(val));
+    ASSERT_EQ(buffer.size(), 2);
+
+    ASSERT_TRUE(buffer.push(0, 0));
+
+    for (int j = 0; j < 3; ++j) {
+        ASSERT_TRUE(buffer.try_pop(val));
+        ASSERT_EQ(val, j * 10);
+    }
+
+    ASSERT_EQ(buffer.next(), 3);
+    ASSERT_TRUE(buffer.empty());
+
+    // already released
+    ASSERT_FALSE(buffer.push(1, 10));
+}
+
+TEST(TestReorderBuffer, Backpressure) {
+    const std::size_t window = 4;
+    ReorderBuffer<int> buffer{window};
+    std::atomic<bool> pushed{false};
+    int val = 0;
+
+    for (std::size_t i = 0; i < window; ++i) {
+        ASSERT_TRUE(buffer.push(i, i));
+    }
+
+    // a full window ahead of the consumer
+    std::thread producer_thread = std::thread{[&buffer, &pushed, window]() {
+        buffer.push(window, window);
+        pushed = true;
+    }};
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+    ASSERT_FALSE(pushed);
+
+    buffer.wait_and_pop(val);
+    producer_thread.join();
+
+    ASSERT_EQ(val, 0);
+    ASSERT_TRUE(pushed);
+    ASSERT_EQ(buffer.size(), window);
+}
+
+TEST(TestReorderBuffer, ParallelWorkers) {
+    using Item = std::pair<uint64_t, int>;
+    ConcurrentQueue<Item> input{};
+    ReorderBuffer<int> output{16};
+    const int n = 1000;
+    const int workers = 4;
+    std::vector<std::thread> worker_threads{};
+    std::vector<int> results{};
+
+    // the source stamps, the workers square out of order
+    for (int i = 0; i < n; ++i) {
+        input.push({output.next_sequence(), i});
+    }
+
+    for (int w = 0; w < workers; ++w) {
+        worker_threads.push_back(std::thread{[&input, &output, w]() {
+            std::mt19937 gen(w);
+            std::uniform_int_distribution<int> dist{0, 100};
+            Item item{};
+
+            while (input.try_pop(item)) {
+                std::this_thread::sleep_for(std::chrono::microseconds{dist(gen)});
+                output.push(item.first, item.second * item.second);
+            }
+        }});
+    }
+
+    int val = 0;
+    for (int j = 0; j < n; ++j) {
+        output.wait_and_pop(val);
+        results.push_back(val);
+    }
+
+    for (auto& t : worker_threads) {
+        t.join();
+    }
+
+    for (int j = 0; j < n; ++j) {
+        ASSERT_EQ(results[j], j * j);
+    }
+
+    std::cout << "Released " << results.size() << " results of " << workers << " workers in order.\n";
+
+    ASSERT_TRUE(output.empty());
+}
+
+TEST(TestReorderBuffer, WaitAndPopWhileWithTimeout) {
+    ReorderBuffer<int> buffer{4};
+    const std::chrono::milliseconds timeout{50};
+    const std::chrono::milliseconds check{5};
+    int val = 0;
+
+    buffer.push(1, 1);
+
+    ASSERT_FALSE(buffer.wait_and_pop_while(val, timeout, check));
+
+    buffer.push(0, 0);
+
+    ASSERT_TRUE(buffer.wait_and_pop_while(val, timeout, check));
+    ASSERT_EQ(val, 0);
+}
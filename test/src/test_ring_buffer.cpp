@@ -0,0 +1,114 @@
+#include "gtest/gtest.h"
+#include "../../include/concurrent_queue.h"
+#include "../../include/ring_buffer.h"
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+TEST(TestRingBuffer, WrapAroundAndGrow) {
+    RingBuffer<int> ring{};
+    int next_in = 0;
+    int next_out = 0;
+
+    // the head wanders around the ring before it has to grow
+    for (int round = 0; round < 100; ++round) {
+        for (int i = 0; i < 10; ++i) {
+            ring.push(next_in++);
+        }
+        for (int i = 0; i < 9; ++i) {
+            ASSERT_EQ(ring.front(), next_out++);
+            ring.pop();
+        }
+    }
+
+    ASSERT_EQ(ring.size(), 100);
+    ASSERT_EQ(ring.capacity(), 128);
+    ASSERT_EQ(ring.back(), next_in - 1);
+
+    while (!ring.empty()) {
+        ASSERT_EQ(ring.front(), next_out++);
+        ring.pop();
+    }
+
+    ASSERT_EQ(next_out, next_in);
+}
+
+TEST(TestRingBuffer, NeverShrinks) {
+    RingBuffer<std::string> ring{};
+
+    for (int i = 0; i < 1000; ++i) {
+        ring.push(std::to_string(i));
+    }
+
+    std::size_t high_water = ring.capacity();
+    ASSERT_EQ(high_water, 1024);
+
+    ring.clear();
+    ASSERT_TRUE(ring.empty());
+    ASSERT_EQ(ring.capacity(), high_water);
+
+    for (int i = 0; i < 1000; ++i) {
+        ring.push(std::to_string(i));
+        ring.pop();
+    }
+
+    ASSERT_EQ(ring.capacity(), high_water);
+}
+
+TEST(TestRingBuffer, MoveOnlyElements) {
+    RingBuffer<std::unique_ptr<int>> ring{};
+    std::shared_ptr<int> counted = std::make_shared<int>(0);
+    RingBuffer<std::shared_ptr<int>> owners{};
+
+    for (int i = 0; i < 50; ++i) {
+        ring.push(std::unique_ptr<int>{new int{i}});
+        owners.push(counted);
+    }
+
+    ASSERT_EQ(*ring.front(), 0);
+    ASSERT_EQ(counted.use_count(), 51);
+
+    RingBuffer<std::shared_ptr<int>> moved{std::move(owners)};
+    ASSERT_TRUE(owners.empty());
+    ASSERT_EQ(moved.size(), 50);
+
+    moved.clear();
+    ASSERT_EQ(counted.use_count(), 1);
+}
+
+TEST(TestRingBuffer, ConcurrentQueueStorage) {
+    using Tuple = std::tuple<uint32_t, uint32_t, uint32_t>;
+    ConcurrentQueue<Tuple, RingBuffer<Tuple>> queue{};
+    const uint32_t n = 100000;
+    uint64_t sum = 0;
+
+    std::thread producer_thread = std::thread{[&queue, n]() {
+        for (uint32_t i = 1; i <= n; ++i) {
+            queue.push(Tuple{i, i, i});
+        }
+    }};
+
+    Tuple ta{};
+    for (uint32_t j = 1; j <= n; ++j) {
+        queue.wait_and_pop(ta);
+        ASSERT_EQ(std::get<0>(ta), j);
+        sum += std::get<2>(ta);
+    }
+
+    producer_thread.join();
+
+    ASSERT_EQ(sum, static_cast<uint64_t>(n) * (n + 1) / 2);
+
+    std::vector<Tuple> batch{};
+    for (uint32_t i = 0; i < 10; ++i) {
+        queue.push(Tuple{i, 0, 0});
+    }
+    ASSERT_EQ(queue.pop_batch(batch, 100, std::chrono::milliseconds{0}), 10);
+
+    queue.push(Tuple{});
+    queue.clear();
+    ASSERT_TRUE(queue.empty());
+}
@@ -0,0 +1,139 @@
+#include "gtest/gtest.h"
+#include "../../include/synchronous_queue.h"
+#include <iostream>
+#include <memory>
+#include <vector>
+
+TEST(TestSynchronousQueue, SumWaitAndPop) {
+    SynchronousQueue<int> queue{};
+    const int n = 1000;
+    const int expected_sum = n * (n + 1) / 2;
+    int sum = 0;
+
+    auto producer = [&queue, n]() {
+        for (int i = 1; i <= n; ++i) {
+            queue.push(i);
+        }
+    };
+
+    auto consumer = [&queue, &sum, n]() {
+        int val = 0;
+
+        for (int j = 1; j <= n; ++j) {
+            queue.wait_and_pop(val);
+            sum += val;
+        }
+    };
+
+    std::thread producer_thread = std::thread{producer};
+    std::thread consumer_thread = std::thread{consumer};
+
+    producer_thread.join();
+    consumer_thread.join();
+
+    ASSERT_EQ(sum, expected_sum);
+
+    std::cout << "Sum of numbers handed off between [1," << n << "] is " << sum << ".\n";
+
+    ASSERT_TRUE(queue.empty());
+}
+
+TEST(TestSynchronousQueue, PushBlocksUntilTaken) {
+    SynchronousQueue<int> queue{};
+    const std::chrono::milliseconds delay{100};
+    std::chrono::steady_clock::time_point t_pushed;
+    int val = 0;
+
+    auto producer = [&queue, &t_pushed]() {
+        queue.push(42);
+        t_pushed = std::chrono::steady_clock::now();
+    };
+
+    auto t_start = std::chrono::steady_clock::now();
+    std::thread producer_thread = std::thread{producer};
+
+    std::this_thread::sleep_for(delay);
+    queue.wait_and_pop(val);
+    producer_thread.join();
+
+    ASSERT_EQ(val, 42);
+    ASSERT_TRUE(t_pushed - t_start >= delay);
+}
+
+TEST(TestSynchronousQueue, TryPopWithoutProducer) {
+    SynchronousQueue<int> queue{};
+    int val = 0;
+
+    // there is no buffer, nothing to pop
+    ASSERT_FALSE(queue.try_pop(val));
+    ASSERT_TRUE(queue.empty());
+}
+
+TEST(TestSynchronousQueue, WaitAndPopWhileWithTimeout) {
+    SynchronousQueue<int> queue{};
+    const std::chrono::milliseconds timeout{50};
+    const std::chrono::milliseconds check{5};
+    int val = 0;
+
+    ASSERT_FALSE(queue.wait_and_pop_while(val, timeout, check));
+
+    std::thread producer_thread = std::thread{[&queue]() { queue.push(7); }};
+
+    ASSERT_TRUE(queue.wait_and_pop_while(val, std::chrono::seconds{1}, check));
+    ASSERT_EQ(val, 7);
+
+    producer_thread.join();
+}
+
+TEST(TestSynchronousQueue, MoveOnly) {
+    SynchronousQueue<std::unique_ptr<int>> queue{};
+    const int n = 10;
+    int sum = 0;
+
+    auto producer = [&queue, n]() {
+        for (int i = 1; i <= n; ++i) {
+            queue.push(std::unique_ptr<int>{new int{i}});
+        }
+    };
+
+    std::thread producer_thread = std::thread{producer};
+
+    std::unique_ptr<int> val{};
+    for (int j = 1; j <= n; ++j) {
+        queue.wait_and_pop(val);
+        sum += *val;
+    }
+
+    producer_thread.join();
+
+    ASSERT_EQ(sum, n * (n + 1) / 2);
+}
+
+TEST(TestSynchronousQueue, ManyProducersManyConsumers) {
+    SynchronousQueue<int> queue{};
+    const int producers = 3;
+    const int n = 200;
+    std::atomic<int> sum{0};
+    std::vector<std::thread> threads{};
+
+    for (int p = 0; p < producers; ++p) {
+        threads.push_back(std::thread{[&queue, n]() {
+            for (int i = 1; i <= n; ++i) {
+                queue.push(i);
+            }
+        }});
+        threads.push_back(std::thread{[&queue, &sum, n]() {
+            int val = 0;
+            for (int i = 1; i <= n; ++i) {
+                queue.wait_and_pop(val);
+                sum += val;
+            }
+        }});
+    }
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    ASSERT_EQ(sum.load(), producers * n * (n + 1) / 2);
+}